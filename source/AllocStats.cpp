@@ -0,0 +1,243 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "AllocStats.hpp"
+
+#ifdef DRXUTIL_ALLOC_STATS
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace
+{
+
+// Counted per thread, so scopes aren't affected by allocations of other threads.
+// Memory freed by another thread than the one which allocated it lowers the live bytes of the freeing thread,
+// so those are signed.
+thread_local std::size_t allocationCount = 0;
+thread_local std::size_t allocatedBytes = 0;
+thread_local std::ptrdiff_t liveBytes = 0;
+thread_local std::ptrdiff_t peakLiveBytes = 0;
+
+// Allocations are prefixed with their size, this keeps the default new alignment
+constexpr std::size_t HEADER_SIZE = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+// Over-aligned allocations use a header as large as their alignment, so the returned pointer stays aligned
+constexpr std::size_t GetHeaderSize(std::size_t alignment)
+{
+    return std::max(alignment, HEADER_SIZE);
+}
+
+void* CountedAlloc(std::size_t size, std::size_t alignment = HEADER_SIZE)
+{
+    const std::size_t headerSize = GetHeaderSize(alignment);
+    void* ptr;
+    if (alignment <= HEADER_SIZE) {
+        ptr = std::malloc(size + headerSize);
+    } else {
+        // aligned_alloc wants the size to be a multiple of the alignment
+        ptr = std::aligned_alloc(alignment, (size + headerSize + alignment - 1) & ~(alignment - 1));
+    }
+
+    if (!ptr) {
+        return nullptr;
+    }
+
+    *static_cast<std::size_t*>(ptr) = size;
+
+    allocationCount++;
+    allocatedBytes += size;
+    liveBytes += std::ptrdiff_t(size);
+    peakLiveBytes = std::max(peakLiveBytes, liveBytes);
+
+    return static_cast<std::byte*>(ptr) + headerSize;
+}
+
+void CountedFree(void* ptr, std::size_t alignment = HEADER_SIZE)
+{
+    if (!ptr) {
+        return;
+    }
+
+    void* block = static_cast<std::byte*>(ptr) - GetHeaderSize(alignment);
+    liveBytes -= std::ptrdiff_t(*static_cast<std::size_t*>(block));
+    std::free(block);
+}
+
+void* CountedNew(std::size_t size, std::size_t alignment = HEADER_SIZE)
+{
+    void* ptr = CountedAlloc(size ? size : 1, alignment);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+}
+
+namespace AllocStats
+{
+
+Scope::Scope()
+ : mStartAllocations(allocationCount),
+   mStartBytes(allocatedBytes),
+   mStartLiveBytes(liveBytes),
+   // Restart the peak tracking for this scope, the outer peak is restored when leaving
+   mSavedPeakBytes(std::exchange(peakLiveBytes, liveBytes))
+{
+}
+
+Scope::~Scope()
+{
+    peakLiveBytes = std::max(peakLiveBytes, mSavedPeakBytes);
+}
+
+Counters Scope::Get() const
+{
+    Counters counters;
+    counters.allocations = allocationCount - mStartAllocations;
+    counters.bytes = allocatedBytes - mStartBytes;
+    counters.peakBytes = std::max(peakLiveBytes, mStartLiveBytes) - mStartLiveBytes;
+    return counters;
+}
+
+}
+
+void* operator new(std::size_t size)
+{
+    return CountedNew(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return CountedNew(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAlloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAlloc(size ? size : 1);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return CountedNew(size, std::size_t(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return CountedNew(size, std::size_t(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAlloc(size ? size : 1, std::size_t(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAlloc(size ? size : 1, std::size_t(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+    CountedFree(ptr, std::size_t(alignment));
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+    CountedFree(ptr, std::size_t(alignment));
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+    CountedFree(ptr, std::size_t(alignment));
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+    CountedFree(ptr, std::size_t(alignment));
+}
+
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    CountedFree(ptr, std::size_t(alignment));
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    CountedFree(ptr, std::size_t(alignment));
+}
+#else
+namespace AllocStats
+{
+
+// Nothing is counted, so every scope reports zero
+Scope::Scope()
+ : mStartAllocations(0),
+   mStartBytes(0),
+   mStartLiveBytes(0),
+   mSavedPeakBytes(0)
+{
+}
+
+Scope::~Scope()
+{
+}
+
+Counters Scope::Get() const
+{
+    return Counters{};
+}
+
+}
+#endif
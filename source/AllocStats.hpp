@@ -0,0 +1,61 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+
+// Heap allocation counting, hooks into the global operator new/delete (including the aligned overloads).
+// Only active if built with DRXUTIL_ALLOC_STATS defined (make ALLOC_STATS=1),
+// otherwise all counters stay zero.
+namespace AllocStats
+{
+
+#ifdef DRXUTIL_ALLOC_STATS
+constexpr bool ENABLED = true;
+#else
+constexpr bool ENABLED = false;
+#endif
+
+struct Counters {
+    // Number of allocations
+    std::size_t allocations;
+    // Total amount of bytes allocated
+    std::size_t bytes;
+    // Highest amount of live bytes, relative to the live bytes when the scope was entered
+    std::size_t peakBytes;
+};
+
+// Counts allocations made during the lifetime of the scope.
+// Scopes can be nested, only allocations of the thread which created the scope are counted.
+class Scope {
+public:
+    Scope();
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    Counters Get() const;
+
+private:
+    std::size_t mStartAllocations;
+    std::size_t mStartBytes;
+    std::ptrdiff_t mStartLiveBytes;
+    std::ptrdiff_t mSavedPeakBytes;
+};
+
+}
@@ -0,0 +1,235 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "DRC.hpp"
+#include "Wait.hpp"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <optional>
+#include <vector>
+
+#ifdef __WIIU__
+#include <coreinit/debug.h>
+#endif
+
+namespace
+{
+
+void Report(const char* format, ...)
+{
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+
+#ifdef __WIIU__
+    OSReport("DRXUtil: %s\n", buf);
+#else
+    std::fprintf(stderr, "%s\n", buf);
+#endif
+}
+
+void EnterStage(const DRC::FlashHooks& hooks, DRC::FlashStage stage)
+{
+    if (hooks.onStage) {
+        hooks.onStage(stage);
+    }
+}
+
+// Abort a failed update and put the DRC back into active mode
+std::unexpected<std::string> FailUpdate(Platform& platform, std::string error)
+{
+    DRC::AbortUpdate(platform);
+    DRC::Reattach(platform, Platform::DRCState::ACTIVE);
+    return std::unexpected(std::move(error));
+}
+
+}
+
+namespace DRC
+{
+
+bool CaffeineInvalidate(Platform& platform)
+{
+    Platform::SoftwareVersion version{};
+    platform.GetSoftwareVersion(Platform::Destination::DRC0, version);
+
+    // Only newer versions have caffeine
+    if (version.runningVersion >= 0x180a0000) {
+        return platform.SetCaffeineSlot(0xff);
+    }
+
+    return true;
+}
+
+bool WaitForEeprom(Platform& platform)
+{
+    Wait::Result result = Wait::Until(platform, [&platform]() {
+        std::uint8_t val;
+        return platform.ReadEeprom(0, std::span(&val, 1));
+    }, { .initialIntervalMs = 10, .maxIntervalMs = 200, .timeoutMs = 2000 });
+
+    Report("EEPROM %s after %u ms", result ? "ready" : "timed out", unsigned(result.elapsedMs));
+    return result.success;
+}
+
+bool Reattach(Platform& platform, Platform::DRCState targetState)
+{
+    // Get the current DRC state
+    Platform::DRCState state;
+    if (!platform.GetDRCState(state)) {
+        return false;
+    }
+
+    if (state == Platform::DRCState::STANDALONE) {
+        state = Platform::DRCState::ACTIVE;
+    }
+
+    // Nothing to do if we're already in the target state
+    if (state == targetState) {
+        return true;
+    }
+
+    platform.InitReattach();
+
+    // Set target state
+    if (!platform.SetDRCState(targetState)) {
+        return false;
+    }
+
+    // Wait for the DRC to reattach
+    if (!platform.WaitReattach()) {
+        return false;
+    }
+
+    // Wait for EEPROM
+    if (!WaitForEeprom(platform)) {
+        return false;
+    }
+
+    // Check if we're in the state we want
+    if (!platform.GetDRCState(state)) {
+        return false;
+    }
+
+    return state == targetState;
+}
+
+bool AbortUpdate(Platform& platform)
+{
+    Wait::Result result = Wait::Until(platform, [&platform]() {
+        return platform.AbortUpdate();
+    }, { .initialIntervalMs = 10, .maxIntervalMs = 200, .timeoutMs = 3000 });
+
+    Report("Update abort %s after %u ms", result ? "done" : "timed out", unsigned(result.elapsedMs));
+    return result.success;
+}
+
+bool Reactivate(Platform& platform)
+{
+    // A full reattach is expensive, so this starts slower than the other waits
+    Wait::Result result = Wait::Until(platform, [&platform]() {
+        return Reattach(platform, Platform::DRCState::ACTIVE);
+    }, { .initialIntervalMs = 100, .maxIntervalMs = 1000, .timeoutMs = 10000 });
+
+    Report("DRC %s after %u ms (%u attempts)", result ? "reattached" : "reattach timed out",
+        unsigned(result.elapsedMs), unsigned(result.attempts));
+    return result.success;
+}
+
+bool GetEepromValue(Platform& platform, std::uint32_t offset, std::span<std::uint8_t> value)
+{
+    std::vector<std::uint8_t> data(value.size() + 2);
+    if (!platform.ReadEeprom(offset, data)) {
+        return false;
+    }
+
+    std::uint16_t crc = (std::uint16_t) data[value.size() + 1] << 8 | data[value.size()];
+    if (platform.CalcCRC16(std::span(data).first(value.size())) != crc) {
+        return false;
+    }
+
+    std::copy_n(data.begin(), value.size(), value.begin());
+    return true;
+}
+
+bool SetEepromValue(Platform& platform, std::uint8_t configId, std::uint32_t offset, std::uint8_t value)
+{
+    // value + crc16
+    std::uint8_t data[3];
+    data[0] = value;
+    std::uint16_t crc = platform.CalcCRC16(std::span(data, 1));
+    data[1] = crc & 0xff;
+    data[2] = (crc >> 8) & 0xff;
+    if (!platform.SetUicConfig(configId, data)) {
+        return false;
+    }
+
+    // Also update the cached eeprom
+    return platform.WriteEeprom(offset, data);
+}
+
+std::expected<void, std::string> Flash(Platform& platform, const std::string& path, const FlashHooks& hooks)
+{
+    EnterStage(hooks, FlashStage::PREPARE);
+    if (!CaffeineInvalidate(platform)) {
+        return std::unexpected("Failed to invalidate caffeine.");
+    }
+
+    // Abort any potential pending software updates
+    platform.AbortUpdate();
+
+    // Reattach the DRC in update mode
+    if (!Reattach(platform, Platform::DRCState::FWUPDATE)) {
+        Reattach(platform, Platform::DRCState::ACTIVE);
+        return std::unexpected("Failed to reattach DRC in update mode.");
+    }
+
+    // Only set by the callback, WaitUpdate returns after it was called
+    std::optional<std::int32_t> result;
+    if (!platform.StartUpdate(path, [&result](std::int32_t error) { result = error; })) {
+        return FailUpdate(platform, "Failed to start software update.");
+    }
+
+    // The wait ends as soon as the update finished, progress is only polled when it times out
+    EnterStage(hooks, FlashStage::FLASH);
+    while (!platform.WaitUpdate(hooks.pollIntervalMs)) {
+        std::int32_t progress;
+        if (platform.GetUpdateProgress(progress) && hooks.onProgress) {
+            hooks.onProgress(progress);
+        }
+    }
+
+    // IOS_ERROR_OK, the update may also have been cancelled without calling the callback
+    if (result != 0) {
+        return FailUpdate(platform, "Software update failed.");
+    }
+
+    // Activate the newly flashed firmware
+    EnterStage(hooks, FlashStage::ACTIVATE);
+    if (!platform.ActivateUpdate()) {
+        return FailUpdate(platform, "Failed to activate software update.");
+    }
+
+    // Put the gamepad back into active mode, at this point we don't really care if it times out or not
+    Reactivate(platform);
+
+    return {};
+}
+
+}
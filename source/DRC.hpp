@@ -0,0 +1,86 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "Platform.hpp"
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <span>
+#include <string>
+
+// DRC operations shared by the screens, built on top of the Platform.
+// Most of these block until the DRC responds and should not run on the UI thread.
+namespace DRC
+{
+
+// EEPROM offsets of values followed by their CRC16
+constexpr std::uint32_t EEPROM_BOARD_INFO = 0x100;
+constexpr std::uint32_t EEPROM_REGION = 0x103;
+constexpr std::uint32_t EEPROM_DEVICE_INFO = 0x106;
+
+// Custom UIC config ids which were added by the gamepad cfw
+constexpr std::uint8_t UIC_CONFIG_REGION = 1;
+constexpr std::uint8_t UIC_CONFIG_DEVICE_INFO = 4;
+
+// Default for FlashHooks::pollIntervalMs
+constexpr std::uint32_t DEFAULT_PROGRESS_POLL_INTERVAL_MS = 200;
+
+enum class FlashStage {
+    // Reattaching the DRC in update mode
+    PREPARE,
+    // The image is being flashed, progress is reported
+    FLASH,
+    // Activating the new firmware and waiting for the DRC to come back
+    ACTIVATE,
+};
+
+struct FlashHooks {
+    // Called whenever the flash enters the next stage
+    std::function<void(FlashStage stage)> onStage;
+    // Called with the update progress in percent while flashing
+    std::function<void(std::int32_t progress)> onProgress;
+    // How often the update progress is queried while flashing, completion is noticed right away regardless
+    std::uint32_t pollIntervalMs = DEFAULT_PROGRESS_POLL_INTERVAL_MS;
+};
+
+// Invalidate caffeine, so the system doesn't resume the DRC from a cached state
+bool CaffeineInvalidate(Platform& platform);
+
+// Wait until the system read the EEPROM after a reattach
+bool WaitForEeprom(Platform& platform);
+
+// Reattach the DRC in targetState, does nothing if it's already in that state
+bool Reattach(Platform& platform, Platform::DRCState targetState);
+
+// Abort a pending or failed update
+bool AbortUpdate(Platform& platform);
+
+// Put the DRC back into active mode after activating an update, this retries until it rebooted
+bool Reactivate(Platform& platform);
+
+// Read a value from the cached EEPROM and check its CRC16
+bool GetEepromValue(Platform& platform, std::uint32_t offset, std::span<std::uint8_t> value);
+
+// Write a single byte value through a UIC config and update the cached EEPROM
+bool SetEepromValue(Platform& platform, std::uint8_t configId, std::uint32_t offset, std::uint8_t value);
+
+// Flash the image at path and activate it, this blocks until the DRC is back in active mode.
+// On failure the update is aborted and the DRC put back into active mode before returning the error.
+std::expected<void, std::string> Flash(Platform& platform, const std::string& path, const FlashHooks& hooks);
+
+}
@@ -18,12 +18,167 @@
 #include "Utils.hpp"
 #include <algorithm>
 #include <cstring>
+#include <numeric>
 #include <utility>
 #include <ranges>
 #include <cassert>
 
-Resource::Resource(Type type, std::uint16_t id, std::vector<std::byte>&& data)
- : mType(type), mId(id), mData(std::move(data))
+namespace
+{
+
+// Expands each bit of a byte into a byte mask, bit 0 ends up in the first byte in memory
+constexpr std::array<std::uint64_t, 256> kBitMaskTable = [] {
+    std::array<std::uint64_t, 256> table{};
+    for (std::size_t i = 0; i < table.size(); i++) {
+        std::array<std::uint8_t, 8> mask{};
+        for (std::size_t j = 0; j < mask.size(); j++) {
+            mask[j] = ((i >> j) & 1) ? 0xFF : 0x00;
+        }
+
+        table[i] = std::bit_cast<std::uint64_t>(mask);
+    }
+
+    return table;
+}();
+
+void ExpandPalette(const std::uint32_t* __restrict palette, const std::uint8_t* __restrict src, std::uint32_t* __restrict dst, std::size_t count)
+{
+    std::size_t i = 0;
+
+    // Do lookups in blocks of 8, lets the compiler schedule (or gather) the independent loads
+    for (; i + 8 <= count; i += 8) {
+        dst[i + 0] = palette[src[i + 0]];
+        dst[i + 1] = palette[src[i + 1]];
+        dst[i + 2] = palette[src[i + 2]];
+        dst[i + 3] = palette[src[i + 3]];
+        dst[i + 4] = palette[src[i + 4]];
+        dst[i + 5] = palette[src[i + 5]];
+        dst[i + 6] = palette[src[i + 6]];
+        dst[i + 7] = palette[src[i + 7]];
+    }
+
+    for (; i < count; i++) {
+        dst[i] = palette[src[i]];
+    }
+}
+
+// Range of the pages which lie completely within [offset, offset + size) of the payload
+struct PageRange {
+    std::size_t first;
+    std::size_t count;
+};
+
+PageRange WholePages(std::size_t offset, std::size_t size)
+{
+    const std::size_t first = (offset + Firmware::PAGE_SIZE - 1) / Firmware::PAGE_SIZE;
+    const std::size_t end = (offset + size) / Firmware::PAGE_SIZE;
+    return { first, end > first ? end - first : 0 };
+}
+
+// Reads the firmware payload strictly in order and verifies every page against its sub CRC while reading
+class PayloadReader {
+public:
+    PayloadReader(Stream& stream, std::span<const std::uint32_t> pageCRCs, std::size_t payloadSize)
+     : mStream(stream), mPageCRCs(pageCRCs), mPayloadSize(payloadSize), mPosition(0), mCRC(0)
+    {
+    }
+
+    std::size_t GetPosition() const { return mPosition; }
+
+    bool Read(std::span<std::byte> out)
+    {
+        if (out.size() > mPayloadSize - mPosition) {
+            return false;
+        }
+
+        if (mStream.Read(out) != out.size() || mStream.GetError() != Stream::ERROR_OK) {
+            return false;
+        }
+
+        return Verify(out);
+    }
+
+    bool Skip(std::size_t size)
+    {
+        std::array<std::byte, Firmware::PAGE_SIZE> buffer;
+        while (size > 0) {
+            const std::size_t chunk = std::min(size, buffer.size());
+            if (!Read(std::span{buffer}.first(chunk))) {
+                return false;
+            }
+
+            size -= chunk;
+        }
+
+        return true;
+    }
+
+private:
+    bool Verify(std::span<const std::byte> data)
+    {
+        while (!data.empty()) {
+            const std::size_t pageEnd = std::min((mPosition / Firmware::PAGE_SIZE + 1) * Firmware::PAGE_SIZE, mPayloadSize);
+            const std::size_t size = std::min(pageEnd - mPosition, data.size());
+            mCRC = Utils::crc32(data.first(size), mCRC);
+            data = data.subspan(size);
+            mPosition += size;
+
+            // Check the page once it's complete, the last page may be partial
+            if (mPosition == pageEnd) {
+                const std::size_t page = (mPosition - 1) / Firmware::PAGE_SIZE;
+                if (page >= mPageCRCs.size() || mPageCRCs[page] != mCRC) {
+                    return false;
+                }
+
+                mCRC = 0;
+            }
+        }
+
+        return true;
+    }
+
+    Stream& mStream;
+    std::span<const std::uint32_t> mPageCRCs;
+    std::size_t mPayloadSize;
+    std::size_t mPosition;
+    std::uint32_t mCRC;
+};
+
+}
+
+FirmwareSegments::FirmwareSegments()
+{
+}
+
+FirmwareSegments::~FirmwareSegments()
+{
+}
+
+void FirmwareSegments::Append(std::span<const std::byte> segment)
+{
+    mSegments.push_back(segment);
+}
+
+std::span<std::byte> FirmwareSegments::Append(std::size_t size)
+{
+    // The heap buffer of the inner vector stays in place, even if mBuffers is reallocated
+    std::span<std::byte> buffer = mBuffers.emplace_back(size);
+    mSegments.push_back(buffer);
+    return buffer;
+}
+
+std::size_t FirmwareSegments::GetSize() const
+{
+    std::size_t size = 0;
+    for (const auto& segment : mSegments) {
+        size += segment.size();
+    }
+
+    return size;
+}
+
+Resource::Resource(const Descriptor& descriptor, std::span<std::byte> data)
+ : mDescriptor(std::addressof(descriptor)), mData(data)
 {
 }
 
@@ -31,8 +186,8 @@ Resource::~Resource()
 {
 }
 
-BitmapResource::BitmapResource(std::uint16_t id, std::uint32_t format, std::uint32_t width, std::uint32_t height, std::vector<std::byte>&& data)
- : Resource(Resource::Type::BITMAP, id, std::move(data)), mFormat(format), mWidth(width), mHeight(height)
+BitmapResource::BitmapResource(const Descriptor& descriptor, std::span<std::byte> data)
+ : Resource(descriptor, data)
 {
 }
 
@@ -47,16 +202,85 @@ std::span<const std::uint32_t, 256> BitmapResource::GetPalette() const
 
 std::uint8_t BitmapResource::GetPixel(std::uint32_t x, std::uint32_t y) const
 {
-    if (x > mWidth || y > mHeight) {
+    if (x >= GetWidth() || y >= GetHeight()) {
+        return 0;
+    }
+
+    const std::size_t offset = PALETTE_SIZE + std::size_t(y) * GetWidth() + x;
+    if (offset >= mData.size()) {
+        return 0;
+    }
+
+    return std::uint8_t(mData[offset]);
+}
+
+bool BitmapResource::ExpandToRGBA(std::span<std::uint32_t> out, std::uint32_t stride) const
+{
+    const std::uint32_t width = GetWidth();
+    const std::uint32_t height = GetHeight();
+    if (stride == 0) {
+        stride = width;
+    }
+
+    std::span<const std::byte> pixels = GetPixels();
+    if (pixels.empty() || stride < width) {
         return false;
     }
 
-    return std::uint8_t(mData.at((256 * 4) + y * mWidth + x));
+    if (height > 0 && out.size() < std::size_t(stride) * (height - 1) + width) {
+        return false;
+    }
+
+    const std::uint32_t* palette = GetPalette().data();
+    const std::uint8_t* src = reinterpret_cast<const std::uint8_t*>(pixels.data());
+    if (stride == width) {
+        // Rows are contiguous, expand everything at once
+        ExpandPalette(palette, src, out.data(), pixels.size());
+        return true;
+    }
+
+    for (std::uint32_t y = 0; y < height; y++) {
+        ExpandPalette(palette, src + std::size_t(y) * width, out.data() + std::size_t(y) * stride, width);
+    }
+
+    return true;
+}
+
+bool BitmapResource::ExpandRowToRGBA(std::uint32_t y, std::span<std::uint32_t> out) const
+{
+    std::span<const std::byte> pixels = GetPixels();
+    if (pixels.empty() || y >= GetHeight() || out.size() < GetWidth()) {
+        return false;
+    }
+
+    const std::uint8_t* src = reinterpret_cast<const std::uint8_t*>(pixels.data()) + std::size_t(y) * GetWidth();
+    ExpandPalette(GetPalette().data(), src, out.data(), GetWidth());
+    return true;
+}
+
+std::span<std::byte> BitmapResource::GetPixels()
+{
+    const std::size_t size = std::size_t(GetWidth()) * GetHeight();
+    if (mData.size() < PALETTE_SIZE + size) {
+        return {};
+    }
+
+    return mData.subspan(PALETTE_SIZE, size);
+}
+
+std::span<const std::byte> BitmapResource::GetPixels() const
+{
+    const std::size_t size = std::size_t(GetWidth()) * GetHeight();
+    if (mData.size() < PALETTE_SIZE + size) {
+        return {};
+    }
+
+    return std::span<const std::byte>(mData).subspan(PALETTE_SIZE, size);
 }
 
 void BitmapResource::BlendBitmap(std::span<const std::uint8_t> pixels, std::uint32_t width, std::uint32_t height)
 {
-    if (width > mWidth || height > mHeight) {
+    if (width > GetWidth() || height > GetHeight()) {
         return;
     }
 
@@ -64,41 +288,144 @@ void BitmapResource::BlendBitmap(std::span<const std::uint8_t> pixels, std::uint
         return;
     }
 
+    std::span<std::byte> dst = GetPixels();
+    if (dst.empty()) {
+        return;
+    }
+
     for (std::uint32_t y = 0; y < height; y++) {
         for (std::uint32_t x = 0; x < width; x++) {
             std::uint8_t pixel = pixels[y * width + x];
             
             // Most palettes have the last elements all black/transparent, so skip over those to do very basic "blending"
-            if (pixel == 0xFF) {
+            if (pixel == TRANSPARENT_INDEX) {
                 continue;
             }
 
-            mData[(256 * 4) + y * mWidth + x] = std::byte(pixel);
+            dst[y * GetWidth() + x] = std::byte(pixel);
         }
     }
 }
 
-void BitmapResource::BlendBitmapBits(std::span<const std::uint8_t> bits, std::uint8_t paletteIdx, std::uint32_t width, std::uint32_t height)
+void BitmapResource::BlendBitmapBits(std::span<const std::uint8_t> bits, std::uint8_t paletteIdx, std::uint32_t width, std::uint32_t height,
+                                     std::int32_t x, std::int32_t y, std::uint32_t stride)
 {
-    if (width > mWidth || height > mHeight) {
+    const std::size_t rowBytes = (std::size_t(width) + 7) / 8;
+    if (stride == 0) {
+        stride = rowBytes;
+    }
+
+    if (width == 0 || height == 0 || stride < rowBytes) {
         return;
     }
 
-    if (width * height > bits.size() * 8) {
+    if (std::size_t(stride) * (height - 1) + rowBytes > bits.size()) {
         return;
     }
 
-    for (std::uint32_t y = 0; y < height; y++) {
-        for (std::uint32_t x = 0; x < width; x++) {
-            if ((bits[y * (width / 8) + (x / 8)] >> (x % 8)) & 1) {
-                mData[(256 * 4) + y * mWidth + x] = std::byte(paletteIdx);
+    std::span<std::byte> pixels = GetPixels();
+    if (pixels.empty()) {
+        return;
+    }
+
+    // Clip the overlay against the bitmap
+    const std::int64_t dstX0 = std::max<std::int64_t>(x, 0);
+    const std::int64_t dstY0 = std::max<std::int64_t>(y, 0);
+    const std::int64_t dstX1 = std::min<std::int64_t>(std::int64_t(x) + width, GetWidth());
+    const std::int64_t dstY1 = std::min<std::int64_t>(std::int64_t(y) + height, GetHeight());
+    if (dstX0 >= dstX1 || dstY0 >= dstY1) {
+        return;
+    }
+
+    const std::size_t srcX0 = dstX0 - x;
+    const std::size_t srcY0 = dstY0 - y;
+    const std::uint64_t fill = std::uint64_t(paletteIdx) * 0x0101010101010101ull;
+
+    for (std::int64_t row = 0; row < dstY1 - dstY0; row++) {
+        const std::uint8_t* src = bits.data() + (srcY0 + row) * stride;
+        std::uint8_t* dst = reinterpret_cast<std::uint8_t*>(pixels.data()) + (dstY0 + row) * GetWidth() + dstX0;
+        std::size_t bit = srcX0;
+        std::size_t remaining = dstX1 - dstX0;
+
+        while (remaining >= 8) {
+            const std::size_t shift = bit % 8;
+
+            // Skip over or fill 32 pixels at once, if the source is byte aligned
+            if (shift == 0 && remaining >= 32) {
+                std::uint32_t word;
+                std::memcpy(&word, src + bit / 8, sizeof(word));
+                if (word == 0) {
+                    dst += 32;
+                    bit += 32;
+                    remaining -= 32;
+                    continue;
+                }
+
+                if (word == 0xFFFFFFFFu) {
+                    std::memset(dst, paletteIdx, 32);
+                    dst += 32;
+                    bit += 32;
+                    remaining -= 32;
+                    continue;
+                }
+            }
+
+            // Select 8 pixels at once using a byte mask
+            std::uint8_t byte = src[bit / 8] >> shift;
+            if (shift) {
+                byte |= src[bit / 8 + 1] << (8 - shift);
+            }
+
+            if (byte == 0xFF) {
+                std::memcpy(dst, &fill, sizeof(fill));
+            } else if (byte != 0) {
+                const std::uint64_t mask = kBitMaskTable[byte];
+                std::uint64_t value;
+                std::memcpy(&value, dst, sizeof(value));
+                value = (value & ~mask) | (fill & mask);
+                std::memcpy(dst, &value, sizeof(value));
+            }
+
+            dst += 8;
+            bit += 8;
+            remaining -= 8;
+        }
+
+        // Remaining pixels at the end of the row
+        for (; remaining > 0; remaining--, bit++, dst++) {
+            if ((src[bit / 8] >> (bit % 8)) & 1) {
+                *dst = paletteIdx;
             }
         }
     }
 }
 
-SoundResource::SoundResource(std::uint16_t id, std::uint16_t format, std::uint16_t bits, std::uint32_t channels, std::uint32_t frequency, std::vector<std::byte>&& data)
- : Resource(Resource::Type::SOUND, id, std::move(data)), mFormat(format), mBits(bits), mChannels(channels), mFrequency(frequency)
+void BitmapResource::BlendOverlay(const BitmapOverlay& overlay, std::int32_t x, std::int32_t y)
+{
+    std::span<std::byte> pixels = GetPixels();
+    if (pixels.empty()) {
+        return;
+    }
+
+    for (const BitmapOverlay::Run& run : overlay.runs) {
+        const std::int64_t dstY = std::int64_t(y) + run.y;
+        if (dstY < 0 || dstY >= GetHeight()) {
+            continue;
+        }
+
+        // Clip the run against the bitmap
+        const std::int64_t dstX0 = std::max<std::int64_t>(std::int64_t(x) + run.x, 0);
+        const std::int64_t dstX1 = std::min<std::int64_t>(std::int64_t(x) + run.x + run.length, GetWidth());
+        if (dstX0 >= dstX1) {
+            continue;
+        }
+
+        std::fill_n(pixels.begin() + dstY * GetWidth() + dstX0, dstX1 - dstX0, std::byte(overlay.paletteIdx));
+    }
+}
+
+SoundResource::SoundResource(const Descriptor& descriptor, std::span<std::byte> data)
+ : Resource(descriptor, data)
 {
 }
 
@@ -106,8 +433,8 @@ SoundResource::~SoundResource()
 {
 }
 
-UnknownResource::UnknownResource(Type type, std::uint16_t id, std::vector<std::byte>&& parameters, std::vector<std::byte>&& data)
- : Resource(type, id, std::move(data)), mParameters(std::move(parameters))
+UnknownResource::UnknownResource(const Descriptor& descriptor, std::span<std::byte> data)
+ : Resource(descriptor, data)
 {
 }
 
@@ -124,6 +451,11 @@ FirmwareSection::~FirmwareSection()
 {
 }
 
+void FirmwareSection::SerializeSegments(FirmwareSegments& segments) const
+{
+    SerializeInto(segments.Append(SerializedSize()));
+}
+
 std::optional<FirmwareSection::Header> FirmwareSection::Header::FromStream(Stream& stream)
 {
     FirmwareSection::Header header;
@@ -142,7 +474,7 @@ std::optional<FirmwareSection::Header> FirmwareSection::Header::FromStream(Strea
 }
 
 ResourceSection::ResourceSection(const std::array<char, 4>& name, std::uint32_t version)
- : FirmwareSection(name, version)
+ : FirmwareSection(name, version), mDataSize(0)
 {
 
 }
@@ -159,62 +491,58 @@ std::shared_ptr<ResourceSection> ResourceSection::FromBytes(const std::array<cha
     std::uint32_t descriptorCount;
     stream >> descriptorCount; 
 
-    std::size_t dataPosition = stream.GetPosition() + descriptorCount * Resource::DESCRIPTOR_SIZE;
+    if (stream.GetError() != Stream::ERROR_OK || descriptorCount > stream.GetRemaining() / Resource::DESCRIPTOR_SIZE) {
+        return nullptr;
+    }
+
+    const std::size_t dataPosition = stream.GetPosition() + descriptorCount * Resource::DESCRIPTOR_SIZE;
+    const std::span<const std::byte> data = bytes.subspan(dataPosition);
 
-    // Unpack resources
+    // Unpack resource descriptors
+    std::vector<Resource::Descriptor>& descriptors = resourceSection->mDescriptors;
+    std::vector<std::uint32_t> dataOffsets(descriptorCount);
+    descriptors.resize(descriptorCount);
+    std::size_t arenaSize = 0;
     for (std::uint32_t i = 0; i < descriptorCount; i++) {
-        Resource::Type type;
-        std::uint16_t id;
-        std::uint32_t offset;
-        std::uint32_t size;
-        stream >> type;
-        stream >> id;
-        stream >> offset;
-        stream >> size;
+        Resource::Descriptor& descriptor = descriptors[i];
+        stream >> descriptor.type;
+        stream >> descriptor.id;
+        stream >> dataOffsets[i];
+        stream >> descriptor.size;
 
-        if (stream.GetError() != Stream::ERROR_OK) {
-            return nullptr;
+        // Unpack resource specific parameters
+        if (descriptor.type == Resource::Type::BITMAP) {
+            stream >> descriptor.parameters.bitmap.format;
+            stream >> descriptor.parameters.bitmap.width;
+            stream >> descriptor.parameters.bitmap.height;
+        } else if (descriptor.type == Resource::Type::SOUND) {
+            stream >> descriptor.parameters.sound.format;
+            stream >> descriptor.parameters.sound.bits;
+            stream >> descriptor.parameters.sound.channels;
+            stream >> descriptor.parameters.sound.frequency;
+        } else {
+            stream >> descriptor.parameters.raw;
         }
 
-        // Read resource data
-        std::vector<std::byte> data(size);
-        std::size_t previousPosition = stream.GetPosition();
-        stream.SetPosition(dataPosition + offset);
-        stream.Read(data);
-        stream.SetPosition(previousPosition);
-
         if (stream.GetError() != Stream::ERROR_OK) {
             return nullptr;
         }
 
-        // Unpack resource specific parameters
-        if (type == Resource::Type::BITMAP) {
-            std::uint32_t format;
-            std::uint32_t width;
-            std::uint32_t height;
-            stream >> format;
-            stream >> width;
-            stream >> height;
-            resourceSection->mResources.emplace_back(std::make_shared<BitmapResource>(id, format, width, height, std::move(data)));
-        } else if (type == Resource::Type::SOUND) {
-            std::uint16_t format;
-            std::uint16_t bits;
-            std::uint32_t channels;
-            std::uint32_t frequency;
-            stream >> format;
-            stream >> bits;
-            stream >> channels;
-            stream >> frequency;
-            resourceSection->mResources.emplace_back(std::make_shared<SoundResource>(id, format, bits, channels, frequency, std::move(data)));
-        } else {
-            std::vector<std::byte> param(12);
-            stream >> std::span{param};
-            resourceSection->mResources.emplace_back(std::make_shared<UnknownResource>(type, id, std::move(param), std::move(data)));
-        }
-
-        if (stream.GetError() != Stream::ERROR_OK) {
+        if (dataOffsets[i] > data.size() || descriptor.size > data.size() - dataOffsets[i]) {
             return nullptr;
         }
+
+        // Keep resource data aligned in the arena, so palettes can be accessed directly
+        descriptor.offset = arenaSize;
+        arenaSize = (arenaSize + descriptor.size + (ARENA_ALIGNMENT - 1)) & ~(ARENA_ALIGNMENT - 1);
+        resourceSection->mDataSize += descriptor.size;
+    }
+
+    // Copy all resource data into the arena with a single allocation
+    resourceSection->mArena.resize(arenaSize);
+    for (std::uint32_t i = 0; i < descriptorCount; i++) {
+        const Resource::Descriptor& descriptor = descriptors[i];
+        std::copy_n(data.begin() + dataOffsets[i], descriptor.size, resourceSection->mArena.begin() + descriptor.offset);
     }
 
     return resourceSection;
@@ -222,66 +550,64 @@ std::shared_ptr<ResourceSection> ResourceSection::FromBytes(const std::array<cha
 
 std::vector<std::byte> ResourceSection::ToBytes() const
 {
-    std::vector<std::byte> bytes;
-    VectorStream stream(bytes, std::endian::little);
+    std::vector<std::byte> bytes(SerializedSize());
+    SerializeInto(bytes);
+    return bytes;
+}
 
-    stream << std::uint32_t(mResources.size());
+std::size_t ResourceSection::SerializedSize() const
+{
+    return sizeof(std::uint32_t) + mDescriptors.size() * Resource::DESCRIPTOR_SIZE + mDataSize;
+}
 
-    std::size_t descriptorPosition = stream.GetPosition();
+void ResourceSection::SerializeInto(std::span<std::byte> out) const
+{
+    assert(out.size() == SerializedSize());
 
-    // reserve space for resource descriptors
-    const std::size_t descriptorsSize = mResources.size() * Resource::DESCRIPTOR_SIZE;
-    for (std::size_t i = 0; i < descriptorsSize; i++) {
-        stream << std::byte(0);
-    }
+    MutableSpanStream stream(out, std::endian::little);
 
-    // Write resource data
-    std::size_t dataPosition = stream.GetPosition();
-    std::vector<std::size_t> resourceOffsets;
-    for (auto resource : mResources) {
-        resourceOffsets.push_back(stream.GetPosition() - dataPosition);
-        stream.Write(resource->GetData());
-    }
-
-    // Write resource descriptors
-    stream.SetPosition(descriptorPosition);
-    for (auto [resource, offset] : std::views::zip(mResources, resourceOffsets)) {
-        stream << resource->GetType();
-        stream << resource->GetID();
-        stream << std::uint32_t(offset);
-        stream << std::uint32_t(resource->GetData().size());
-
-        if (resource->GetType() == Resource::Type::BITMAP) {
-            auto bitmap = std::dynamic_pointer_cast<BitmapResource>(resource);
-            assert(bitmap != nullptr);
-
-            stream << bitmap->GetFormat();
-            stream << bitmap->GetWidth();
-            stream << bitmap->GetHeight();
-        } else if (resource->GetType() == Resource::Type::SOUND) {
-            auto sound = std::dynamic_pointer_cast<SoundResource>(resource);
-            assert(sound != nullptr);
-
-            stream << sound->GetFormat();
-            stream << sound->GetBits();
-            stream << sound->GetChannels();
-            stream << sound->GetFrequency();
-        } else {
-            auto unknown = std::dynamic_pointer_cast<UnknownResource>(resource);
-            assert(unknown != nullptr);
+    stream << std::uint32_t(mDescriptors.size());
 
-            stream << std::span{unknown->GetParameters()};
+    // Resource data is packed in order right after the descriptors,
+    // so the offsets are known upfront and everything is written in a single pass
+    std::size_t offset = 0;
+    for (const Resource::Descriptor& descriptor : mDescriptors) {
+        stream << descriptor.type;
+        stream << descriptor.id;
+        stream << std::uint32_t(offset);
+        stream << descriptor.size;
+
+        switch (descriptor.type) {
+        case Resource::Type::BITMAP:
+            stream << descriptor.parameters.bitmap.format;
+            stream << descriptor.parameters.bitmap.width;
+            stream << descriptor.parameters.bitmap.height;
+            break;
+        case Resource::Type::SOUND:
+            stream << descriptor.parameters.sound.format;
+            stream << descriptor.parameters.sound.bits;
+            stream << descriptor.parameters.sound.channels;
+            stream << descriptor.parameters.sound.frequency;
+            break;
+        default:
+            stream << descriptor.parameters.raw;
+            break;
         }
+
+        offset += descriptor.size;
     }
 
-    return bytes;
+    // Write resource data
+    for (const Resource::Descriptor& descriptor : mDescriptors) {
+        stream.Write(GetResourceData(descriptor));
+    }
 }
 
-std::shared_ptr<Resource> ResourceSection::GetResource(std::uint16_t id)
+const Resource::Descriptor* ResourceSection::FindDescriptor(std::uint16_t id) const
 {
-    for (auto resource : mResources) {
-        if (resource->GetID() == id) {
-            return resource;
+    for (const Resource::Descriptor& descriptor : mDescriptors) {
+        if (descriptor.id == id) {
+            return std::addressof(descriptor);
         }
     }
 
@@ -289,7 +615,7 @@ std::shared_ptr<Resource> ResourceSection::GetResource(std::uint16_t id)
 }
 
 GenericSection::GenericSection(const std::array<char, 4>& name, std::uint32_t version, std::vector<std::byte>&& data)
- : FirmwareSection(name, version), mData(data)
+ : FirmwareSection(name, version), mData(std::move(data))
 {
 
 }
@@ -298,6 +624,18 @@ GenericSection::~GenericSection()
 {
 }
 
+void GenericSection::SerializeInto(std::span<std::byte> out) const
+{
+    assert(out.size() == mData.size());
+
+    std::copy(mData.begin(), mData.end(), out.begin());
+}
+
+void GenericSection::SerializeSegments(FirmwareSegments& segments) const
+{
+    segments.Append(std::span<const std::byte>(mData));
+}
+
 void GenericSection::WriteAt(std::size_t offset, std::span<const std::byte> data)
 {
     if (offset + data.size() > mData.size()) {
@@ -305,6 +643,37 @@ void GenericSection::WriteAt(std::size_t offset, std::span<const std::byte> data
     }
 
     std::copy_n(data.begin(), data.size(), mData.begin() + offset);
+
+    mCRC.reset();
+    mPageCRCAlignment.reset();
+    mPageCRCs.clear();
+}
+
+std::uint32_t GenericSection::GetCRC() const
+{
+    if (!mCRC) {
+        mCRC = Utils::crc32(mData);
+    }
+
+    return *mCRC;
+}
+
+std::span<const std::uint32_t> GenericSection::GetPageCRCs(std::size_t offset) const
+{
+    // Which pages are whole only depends on where the section starts within a page
+    const std::size_t alignment = offset % Firmware::PAGE_SIZE;
+    if (mPageCRCAlignment != alignment) {
+        const PageRange pages = WholePages(alignment, mData.size());
+        const std::size_t start = pages.first * Firmware::PAGE_SIZE - alignment;
+
+        mPageCRCs.resize(pages.count);
+        for (std::size_t i = 0; i < pages.count; i++) {
+            mPageCRCs[i] = Utils::crc32(std::span{mData}.subspan(start + i * Firmware::PAGE_SIZE, Firmware::PAGE_SIZE));
+        }
+        mPageCRCAlignment = alignment;
+    }
+
+    return mPageCRCs;
 }
 
 Firmware::Firmware()
@@ -331,52 +700,83 @@ std::expected<Firmware, std::string> Firmware::FromStream(Stream& stream)
     }
 
     if (!fw.UnpackSections(stream)) {
-        return std::unexpected("Failed to unpack sections");
+        return std::unexpected("Failed to unpack or verify sections");
     }
 
     return fw;
 }
 
-std::vector<std::byte> Firmware::ToBytes() const
+std::expected<void, std::string> Firmware::Verify(Stream& stream)
 {
-    std::vector<std::byte> bytes;
-    VectorStream stream(bytes, std::endian::little);
-
-    auto sectionData = PackSections();
+    Firmware fw;
 
-    // Calculate subCRCs
-    std::vector<std::byte> subCRCData(0x4000, std::byte(0));
-    VectorStream subCRCStream(subCRCData, std::endian::little);
-    for (std::size_t i = 0; i < sectionData.size(); i += 0x1000) {
-        std::size_t size = 0x1000;
-        if (sectionData.size() - i < size) {
-            size = sectionData.size() - i;
-        }
+    stream.SetEndianness(std::endian::little);
 
-        // Write crc
-        subCRCStream << Utils::crc32(std::span{sectionData.data() + i, size});
+    if (!fw.UnpackHeader(stream)) {
+        return std::unexpected("Firmware header verification failed");
     }
 
-    // Write header
-    stream << mType;
-    // super CRCs
-    for (std::size_t i = 0; i < 4; i++) {
-        stream << Utils::crc32(std::span{subCRCData.data() + i * 0x1000, 0x1000});
+    if (stream.GetError() != Stream::ERROR_OK) {
+        return std::unexpected("Stream read failed");
     }
-    // padding
-    for (std::size_t i = 0; i < 0xFE8; i++) {
-        stream << std::byte(0);
+
+    // Only the page CRCs are needed, the payload itself is read page by page and discarded
+    const std::size_t payloadSize = stream.GetRemaining();
+    PayloadReader reader(stream, fw.mPageCRCs, payloadSize);
+    if (!reader.Skip(payloadSize)) {
+        return std::unexpected("Page verification failed");
     }
-    // header CRC
-    stream << Utils::crc32(std::span{bytes.data(), 0xFFC});
 
-    // append sub crcs and section data
-    std::copy(subCRCData.begin(), subCRCData.end(), std::back_inserter(bytes));
-    std::copy(sectionData.begin(), sectionData.end(), std::back_inserter(bytes));
+    return {};
+}
 
+std::vector<std::byte> Firmware::ToBytes() const
+{
+    std::vector<std::byte> bytes(SerializedSize());
+    SerializeInto(bytes);
     return bytes;
 }
 
+std::size_t Firmware::SerializedSize() const
+{
+    return HEADER_SIZE + SUB_CRC_TABLE_SIZE + PackedSectionsSize();
+}
+
+void Firmware::SerializeInto(std::span<std::byte> out) const
+{
+    assert(out.size() == SerializedSize());
+
+    std::span<std::byte> header = out.first(HEADER_SIZE);
+    std::span<std::byte> subCRCData = out.subspan(HEADER_SIZE, SUB_CRC_TABLE_SIZE);
+    std::span<std::byte> sectionData = out.subspan(HEADER_SIZE + SUB_CRC_TABLE_SIZE);
+
+    // Pack sections directly into their final location
+    PackSections(sectionData);
+
+    std::span<const std::byte> payload[] = { sectionData };
+    PackHeader(header, subCRCData, payload);
+}
+
+void Firmware::SerializeSegments(FirmwareSegments& segments) const
+{
+    const std::size_t indxSize = mSections.size() * FirmwareSection::Header::SIZE;
+
+    // The header, subCRCs and indx section are packed into one owned segment
+    std::span<std::byte> headerData = segments.Append(HEADER_SIZE + SUB_CRC_TABLE_SIZE + indxSize);
+    std::span<std::byte> indxData = headerData.subspan(HEADER_SIZE + SUB_CRC_TABLE_SIZE);
+    PackSectionHeaders(indxData);
+
+    // Remaining sections are appended as they are
+    const std::size_t firstSectionSegment = segments.GetSegments().size();
+    for (std::size_t i = 1; i < mSections.size(); i++) {
+        mSections[i]->SerializeSegments(segments);
+    }
+
+    std::vector<std::span<const std::byte>> payload{ indxData };
+    std::ranges::copy(segments.GetSegments().subspan(firstSectionSegment), std::back_inserter(payload));
+    PackHeader(headerData.first(HEADER_SIZE), headerData.subspan(HEADER_SIZE, SUB_CRC_TABLE_SIZE), payload);
+}
+
 std::shared_ptr<FirmwareSection> Firmware::GetSection(std::string name)
 {
     if (name.size() != 4u) {
@@ -424,39 +824,36 @@ bool Firmware::UnpackHeader(Stream& stream)
         }
     }
 
-    size_t fwStartPosition = stream.GetPosition();
-
-    // Verify subCrcs
-    SpanStream subCrcStream(std::span{subCRCData}, std::endian::little);
-    std::vector<std::byte> buffer(0x1000);
-    for (std::size_t i = 0; i < stream.GetRemaining(); i += 0x1000) {
-        std::size_t size = 0x1000;
-        if (size > stream.GetRemaining()) {
-            size = stream.GetRemaining();
-        }
-
-        stream.Read(std::span{buffer.begin(), size});
-        if (stream.GetError() != Stream::ERROR_OK) {
-            return false;
-        }
+    // Keep the CRC of every page, they are verified while unpacking the sections and can be used to compare images later
+    const std::size_t pageCount = (stream.GetRemaining() + PAGE_SIZE - 1) / PAGE_SIZE;
+    if (pageCount > SUB_CRC_TABLE_SIZE / sizeof(std::uint32_t)) {
+        return false;
+    }
 
-        std::uint32_t crc;
-        subCrcStream >> crc;
-        if (crc != Utils::crc32(std::span{buffer.data(), size})) {
-            return false;
-        }
+    SpanStream pageCRCStream(std::span{subCRCData}, std::endian::little);
+    mPageCRCs.resize(pageCount);
+    for (std::uint32_t& crc : mPageCRCs) {
+        pageCRCStream >> crc;
     }
 
-    stream.SetPosition(fwStartPosition);
     return true;
 }
 
 bool Firmware::UnpackSections(Stream& stream)
 {
-    size_t fwStartPosition = stream.GetPosition();
+    // The payload is read exactly once from start to end, without seeking.
+    // Page CRCs are verified on the way and section data is read directly into place.
+    const std::size_t payloadSize = stream.GetRemaining();
+    PayloadReader reader(stream, mPageCRCs, payloadSize);
 
     // Unpack first firmware section header (should be INDX section)
-    auto indexHeader = FirmwareSection::Header::FromStream(stream);
+    std::vector<std::byte> indexData(FirmwareSection::Header::SIZE);
+    if (!reader.Read(indexData)) {
+        return false;
+    }
+
+    SpanStream indexStream(std::span{indexData});
+    auto indexHeader = FirmwareSection::Header::FromStream(indexStream);
     if (!indexHeader) {
         return false;
     }
@@ -467,90 +864,205 @@ bool Firmware::UnpackSections(Stream& stream)
     }
 
     // Make sure the index was supposed to be here
-    if (indexHeader->offset != 0u) {
+    if (indexHeader->offset != 0u || indexHeader->size < FirmwareSection::Header::SIZE) {
+        return false;
+    }
+
+    // Read the rest of the INDX section
+    indexData.resize(indexHeader->size);
+    if (!reader.Read(std::span{indexData}.subspan(FirmwareSection::Header::SIZE))) {
         return false;
     }
 
     // Unpack all sections headers
-    stream.SetPosition(fwStartPosition);
+    SpanStream headerStream(std::span{indexData});
     std::size_t numSections = indexHeader->size / FirmwareSection::Header::SIZE;
     for (std::size_t i = 0; i < numSections; i++) {
-        // Read section header
-        auto header = FirmwareSection::Header::FromStream(stream);
+        auto header = FirmwareSection::Header::FromStream(headerStream);
         if (!header) {
             return false;
         }
 
-        // Read section data
-        std::vector<std::byte> data(header->size);
-        std::size_t previousPosition = stream.GetPosition();
-        stream.SetPosition(fwStartPosition + header->offset);
-        stream.Read(data);
-        stream.SetPosition(previousPosition);
+        mSectionHeaders.push_back(*header);
+    }
 
-        if (stream.GetError() != Stream::ERROR_OK) {
+    // Read section data in the order it's stored in, sections can't overlap
+    std::vector<std::vector<std::byte>> sectionData(numSections);
+    std::vector<std::size_t> readOrder(numSections - 1);
+    std::iota(readOrder.begin(), readOrder.end(), 1u);
+    std::ranges::stable_sort(readOrder, {}, [this](std::size_t i) { return mSectionHeaders[i].offset; });
+    for (std::size_t i : readOrder) {
+        const FirmwareSection::Header& header = mSectionHeaders[i];
+        if (header.size == 0) {
+            continue;
+        }
+
+        if (header.offset < reader.GetPosition() || !reader.Skip(header.offset - reader.GetPosition())) {
+            return false;
+        }
+
+        sectionData[i].resize(header.size);
+        if (!reader.Read(sectionData[i])) {
             return false;
         }
+    }
+
+    // Verify the remaining pages
+    if (!reader.Skip(payloadSize - reader.GetPosition())) {
+        return false;
+    }
 
-        if (std::memcmp(header->name.data(), "IMG_", 4u) == 0) {
-            auto section = ResourceSection::FromBytes(header->name, header->version, std::move(data));
+    sectionData[0] = std::move(indexData);
+    for (std::size_t i = 0; i < numSections; i++) {
+        const FirmwareSection::Header& header = mSectionHeaders[i];
+        if (std::memcmp(header.name.data(), "IMG_", 4u) == 0) {
+            auto section = ResourceSection::FromBytes(header.name, header.version, sectionData[i]);
             if (!section) {
                 return false;
             }
 
             mSections.emplace_back(section);
         } else {
-            mSections.emplace_back(std::make_shared<GenericSection>(header->name, header->version, std::move(data)));
+            auto section = std::make_shared<GenericSection>(header.name, header.version, std::move(sectionData[i]));
+
+            // The page CRCs were just verified, keep them so unchanged sections don't need to be hashed again
+            const PageRange pages = WholePages(header.offset, header.size);
+            section->mPageCRCAlignment = header.offset % PAGE_SIZE;
+            section->mPageCRCs.assign(mPageCRCs.begin() + pages.first, mPageCRCs.begin() + pages.first + pages.count);
+
+            mSections.emplace_back(section);
         }
     }
 
     return true;
 }
 
-std::vector<std::byte> Firmware::PackSections() const
+std::size_t Firmware::PackedSectionsSize() const
+{
+    // the indx section only consists of the section headers
+    std::size_t size = mSections.size() * FirmwareSection::Header::SIZE;
+    for (std::size_t i = 1; i < mSections.size(); i++) {
+        size += mSections[i]->SerializedSize();
+    }
+
+    return size;
+}
+
+void Firmware::PackSections(std::span<std::byte> out) const
 {
-    std::vector<std::byte> bytes;
-    VectorStream stream(bytes, std::endian::little);
+    assert(out.size() == PackedSectionsSize());
 
-    // reserve space for indx section
     const std::size_t indxSize = mSections.size() * FirmwareSection::Header::SIZE;
-    for (std::size_t i = 0; i < indxSize; i++) {
-        stream << std::byte(0);
+    PackSectionHeaders(out.first(indxSize));
+
+    // pack section data (skip over indx sections)
+    std::size_t offset = indxSize;
+    for (std::size_t i = 1; i < mSections.size(); i++) {
+        const std::size_t size = mSections[i]->SerializedSize();
+        mSections[i]->SerializeInto(out.subspan(offset, size));
+        offset += size;
     }
+}
 
-    // pack sections (skip over indx sections)
-    std::vector<FirmwareSection::Header> sectionHeaders(mSections.size());
+void Firmware::PackSectionHeaders(std::span<std::byte> out) const
+{
+    if (mSections.empty()) {
+        return;
+    }
+
+    MutableSpanStream stream(out, std::endian::little);
+
+    // pack indx section header
+    const std::size_t indxSize = mSections.size() * FirmwareSection::Header::SIZE;
+    stream << std::uint32_t(0);
+    stream << std::uint32_t(indxSize);
+    stream << mSections[0]->GetName();
+    stream << mSections[0]->GetVersion();
+
+    // pack remaining section headers, data is packed in order right after the indx section
+    std::size_t offset = indxSize;
     for (std::size_t i = 1; i < mSections.size(); i++) {
-        auto sectionData = mSections[i]->ToBytes();
+        const std::size_t size = mSections[i]->SerializedSize();
 
-        // Prepare header
-        FirmwareSection::Header& section = sectionHeaders.at(i);
-        section.name = mSections[i]->GetName();
-        section.size = sectionData.size();
-        section.offset = stream.GetPosition();
-        section.version = mSections[i]->GetVersion();
+        stream << std::uint32_t(offset);
+        stream << std::uint32_t(size);
+        stream << mSections[i]->GetName();
+        stream << mSections[i]->GetVersion();
 
-        // Write data
-        stream.Write(sectionData);
+        offset += size;
     }
+}
 
-    // prepare indx section header
-    FirmwareSection::Header& indxSection = sectionHeaders.at(0);
-    indxSection.name =  mSections[0]->GetName();
-    indxSection.size = indxSize;
-    indxSection.offset = 0;
-    indxSection.version = mSections[0]->GetVersion();
+std::vector<std::optional<std::uint32_t>> Firmware::GetKnownPageCRCs() const
+{
+    std::vector<std::optional<std::uint32_t>> crcs;
 
-    // pack section headers
-    stream.SetPosition(0);
-    for (const auto& section : sectionHeaders) {
-        stream << section.offset;
-        stream << section.size;
-        stream << section.name;
-        stream << section.version;
+    // Generic sections cache the CRCs of their whole pages, the other sections are always hashed
+    std::size_t offset = mSections.size() * FirmwareSection::Header::SIZE;
+    for (std::size_t i = 1; i < mSections.size(); i++) {
+        const std::size_t size = mSections[i]->SerializedSize();
+        if (const GenericSection* generic = dynamic_cast<const GenericSection*>(mSections[i].get())) {
+            const PageRange pages = WholePages(offset, size);
+            std::span<const std::uint32_t> sectionCRCs = generic->GetPageCRCs(offset);
+            crcs.resize(pages.first + pages.count);
+            std::ranges::copy(sectionCRCs, crcs.begin() + pages.first);
+        }
+
+        offset += size;
     }
 
-    return bytes;
+    return crcs;
+}
+
+void Firmware::PackHeader(std::span<std::byte> header, std::span<std::byte> subCRCData, std::span<const std::span<const std::byte>> sectionData) const
+{
+    const std::vector<std::optional<std::uint32_t>> knownCRCs = GetKnownPageCRCs();
+
+    // Calculate subCRCs over the section data, pages can span across multiple segments
+    std::fill(subCRCData.begin(), subCRCData.end(), std::byte(0));
+    MutableSpanStream subCRCStream(subCRCData, std::endian::little);
+    std::uint32_t crc = 0;
+    std::size_t pageRemaining = PAGE_SIZE;
+    std::size_t page = 0;
+    bool known = !knownCRCs.empty() && knownCRCs[0];
+    for (std::span<const std::byte> segment : sectionData) {
+        while (!segment.empty()) {
+            const std::size_t size = std::min(pageRemaining, segment.size());
+            if (!known) {
+                crc = Utils::crc32(segment.first(size), crc);
+            }
+            segment = segment.subspan(size);
+            pageRemaining -= size;
+
+            if (pageRemaining == 0) {
+                subCRCStream << (known ? *knownCRCs[page] : crc);
+                crc = 0;
+                pageRemaining = PAGE_SIZE;
+                page++;
+                known = page < knownCRCs.size() && knownCRCs[page];
+            }
+        }
+    }
+
+    // Write crc of the last partial page
+    if (pageRemaining != PAGE_SIZE) {
+        subCRCStream << crc;
+    }
+
+    assert(subCRCStream.GetError() == Stream::ERROR_OK);
+
+    // Write header
+    std::fill(header.begin(), header.end(), std::byte(0));
+    MutableSpanStream stream(header, std::endian::little);
+    stream << mType;
+    // super CRCs
+    for (std::size_t i = 0; i < 4; i++) {
+        stream << Utils::crc32(subCRCData.subspan(i * 0x1000, 0x1000));
+    }
+    // padding
+    stream.Skip(0xFE8);
+    // header CRC
+    stream << Utils::crc32(header.first(0xFFC));
 }
 
 FirmwareBlob::FirmwareBlob()
@@ -561,6 +1073,90 @@ FirmwareBlob::~FirmwareBlob()
 {
 }
 
+std::expected<FirmwareBlob::PeekResult, std::string> FirmwareBlob::Peek(Stream& stream)
+{
+    PeekResult result;
+
+    // Unpack big endian firmware blob header
+    stream.SetEndianness(std::endian::big);
+    stream >> result.imageVersion;
+    stream >> result.blockSize;
+    stream >> result.sequencePerSession;
+    stream >> result.imageSize;
+
+    if (stream.GetError() != Stream::ERROR_OK) {
+        return std::unexpected("Stream read failed");
+    }
+
+    if (stream.GetRemaining() != result.imageSize) {
+        return std::unexpected("File size doesn't match image size");
+    }
+
+    if (result.imageSize < Firmware::HEADER_SIZE + Firmware::SUB_CRC_TABLE_SIZE + FirmwareSection::Header::SIZE) {
+        return std::unexpected("Image is too small");
+    }
+
+    std::vector<std::byte> header(Firmware::HEADER_SIZE);
+    std::vector<std::byte> subCRCData(Firmware::SUB_CRC_TABLE_SIZE);
+    stream.Read(std::span{header});
+    stream.Read(std::span{subCRCData});
+
+    if (stream.GetError() != Stream::ERROR_OK) {
+        return std::unexpected("Stream read failed");
+    }
+
+    // Unpack little endian firmware header
+    SpanStream headerStream(std::span{header}, std::endian::little);
+    std::array<std::uint32_t, 4> superCRCs;
+    std::uint32_t headerCRC;
+    headerStream >> result.type;
+    headerStream >> superCRCs;
+    headerStream.Skip(0xFE8); // Padding
+    headerStream >> headerCRC;
+
+    result.headerCRCValid = headerCRC == Utils::crc32(std::span{header.data(), header.size() - sizeof(std::uint32_t)});
+
+    result.superCRCsValid = true;
+    for (std::size_t i = 0; i < superCRCs.size(); ++i) {
+        if (superCRCs[i] != Utils::crc32(std::span{subCRCData.data() + i * 0x1000, 0x1000})) {
+            result.superCRCsValid = false;
+        }
+    }
+
+    const std::size_t payloadSize = result.imageSize - Firmware::HEADER_SIZE - Firmware::SUB_CRC_TABLE_SIZE;
+    const std::size_t pageCount = std::min((payloadSize + Firmware::PAGE_SIZE - 1) / Firmware::PAGE_SIZE,
+                                           Firmware::SUB_CRC_TABLE_SIZE / sizeof(std::uint32_t));
+    SpanStream subCRCStream(std::span{subCRCData}, std::endian::little);
+    result.pageCRCs.resize(pageCount);
+    for (std::uint32_t& crc : result.pageCRCs) {
+        subCRCStream >> crc;
+    }
+
+    // Unpack the INDX section, which only consists of the section headers
+    auto indexHeader = FirmwareSection::Header::FromStream(stream);
+    if (!indexHeader) {
+        return std::unexpected("Stream read failed");
+    }
+
+    if (std::memcmp(indexHeader->name.data(), "INDX", 4u) != 0 || indexHeader->offset != 0u ||
+        indexHeader->size < FirmwareSection::Header::SIZE || indexHeader->size > payloadSize) {
+        return std::unexpected("Invalid INDX section");
+    }
+
+    result.sections.push_back(*indexHeader);
+    const std::size_t numSections = indexHeader->size / FirmwareSection::Header::SIZE;
+    for (std::size_t i = 1; i < numSections; i++) {
+        auto sectionHeader = FirmwareSection::Header::FromStream(stream);
+        if (!sectionHeader) {
+            return std::unexpected("Stream read failed");
+        }
+
+        result.sections.push_back(*sectionHeader);
+    }
+
+    return result;
+}
+
 std::expected<FirmwareBlob, std::string> FirmwareBlob::FromStream(Stream& stream)
 {
     FirmwareBlob blob;
@@ -587,25 +1183,77 @@ std::expected<FirmwareBlob, std::string> FirmwareBlob::FromStream(Stream& stream
     if (!fw) {
         return std::unexpected(fw.error());
     }
-    blob.mFirmware = *fw;
+    blob.mFirmware = std::move(*fw);
 
     return blob;
 }
 
+std::expected<void, std::string> FirmwareBlob::Verify(Stream& stream)
+{
+    std::uint32_t imageVersion;
+    std::uint32_t blockSize;
+    std::uint32_t sequencePerSession;
+    std::uint32_t imageSize;
+
+    // Unpack big endian firmware blob header
+    stream.SetEndianness(std::endian::big);
+    stream >> imageVersion;
+    stream >> blockSize;
+    stream >> sequencePerSession;
+    stream >> imageSize;
+
+    if (stream.GetError() != Stream::ERROR_OK) {
+        return std::unexpected("Stream read failed");
+    }
+
+    if (stream.GetRemaining() != imageSize) {
+        return std::unexpected("File size doesn't match image size");
+    }
+
+    return Firmware::Verify(stream);
+}
+
 std::vector<std::byte> FirmwareBlob::ToBytes() const
 {
-    std::vector<std::byte> bytes;
-    VectorStream stream(bytes, std::endian::big);
+    std::vector<std::byte> bytes(SerializedSize());
+    SerializeInto(bytes);
+    return bytes;
+}
+
+std::size_t FirmwareBlob::SerializedSize() const
+{
+    return HEADER_SIZE + mFirmware.SerializedSize();
+}
 
-    auto firmwareData = mFirmware.ToBytes();
+void FirmwareBlob::SerializeInto(std::span<std::byte> out) const
+{
+    assert(out.size() == SerializedSize());
+
+    std::span<std::byte> firmwareData = out.subspan(HEADER_SIZE);
 
     // Pack header
+    MutableSpanStream stream(out.first(HEADER_SIZE), std::endian::big);
     stream << mImageVersion;
     stream << mBlockSize;
     stream << mSequencePerSession;
     stream << std::uint32_t(firmwareData.size());
 
-    std::copy(firmwareData.begin(), firmwareData.end(), std::back_inserter(bytes));
+    mFirmware.SerializeInto(firmwareData);
+}
 
-    return bytes;
+FirmwareSegments FirmwareBlob::ToSegments() const
+{
+    FirmwareSegments segments;
+
+    std::span<std::byte> header = segments.Append(HEADER_SIZE);
+    mFirmware.SerializeSegments(segments);
+
+    // Pack header
+    MutableSpanStream stream(header, std::endian::big);
+    stream << mImageVersion;
+    stream << mBlockSize;
+    stream << mSequencePerSession;
+    stream << std::uint32_t(segments.GetSize() - HEADER_SIZE);
+
+    return segments;
 }
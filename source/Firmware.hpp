@@ -22,6 +22,26 @@
 
 #include "stream.hpp"
 
+// 1-bit overlay which can be blended onto a BitmapResource, generated from PNGs by tools/png2overlay.py
+struct BitmapOverlay {
+    // Horizontal run of set pixels
+    struct Run {
+        std::uint16_t x;
+        std::uint16_t y;
+        std::uint16_t length;
+    };
+
+    std::uint32_t width;
+    std::uint32_t height;
+    // Palette index set pixels are blended with
+    std::uint8_t paletteIdx;
+    // Bits packed LSB first, each row is (width + 7) / 8 bytes
+    std::span<const std::uint8_t> bits;
+    std::span<const Run> runs;
+};
+
+// Resources are lightweight views into the arena of the ResourceSection they were retrieved from,
+// they are only valid as long as the section is alive.
 class Resource {
 public:
     enum class Type : std::uint16_t {
@@ -32,68 +52,137 @@ public:
 
     static constexpr std::size_t DESCRIPTOR_SIZE = 0x18;
 
-    Resource(Type type, std::uint16_t id, std::vector<std::byte>&& data);
+    struct BitmapParameters {
+        std::uint32_t format;
+        std::uint32_t width;
+        std::uint32_t height;
+    };
+
+    struct SoundParameters {
+        std::uint16_t format;
+        std::uint16_t bits;
+        std::uint32_t channels;
+        std::uint32_t frequency;
+    };
+
+    // Type specific parameters, the active member is selected by the descriptor type
+    union Parameters {
+        BitmapParameters bitmap;
+        SoundParameters sound;
+        std::array<std::byte, 12> raw;
+    };
+
+    struct Descriptor {
+        Type type;
+        std::uint16_t id;
+        // offset into the arena of the section
+        std::uint32_t offset;
+        std::uint32_t size;
+        Parameters parameters;
+    };
+
+    Resource(const Descriptor& descriptor, std::span<std::byte> data);
     virtual ~Resource();
 
-    static std::shared_ptr<Resource> FromStream(Stream& stream);
+    static constexpr bool IsType(Type type) { return true; }
 
-    Type GetType() const { return mType; }
-    std::uint16_t GetID() const { return mId; }
-    const std::vector<std::byte>& GetData() const { return mData; }
+    Type GetType() const { return mDescriptor->type; }
+    std::uint16_t GetID() const { return mDescriptor->id; }
+    std::span<const std::byte> GetData() const { return mData; }
 
 protected:
-    Type mType;
-    std::uint16_t mId;
-    std::vector<std::byte> mData;
+    const Descriptor* mDescriptor;
+    std::span<std::byte> mData;
 };
 
 class BitmapResource : public Resource {
 public:
-    BitmapResource(std::uint16_t id, std::uint32_t format, std::uint32_t width, std::uint32_t height, std::vector<std::byte>&& data);
+    static constexpr std::size_t PALETTE_SIZE = 256 * sizeof(std::uint32_t);
+    // Pixels with this palette index are skipped by BlendBitmap
+    static constexpr std::uint8_t TRANSPARENT_INDEX = 0xFF;
+
+    BitmapResource(const Descriptor& descriptor, std::span<std::byte> data);
     virtual ~BitmapResource();
 
-    std::uint32_t GetFormat() const { return mFormat; }
-    std::uint32_t GetWidth() const { return mWidth; }
-    std::uint32_t GetHeight() const { return mHeight; }
+    static constexpr bool IsType(Type type) { return type == Type::BITMAP; }
+
+    std::uint32_t GetFormat() const { return mDescriptor->parameters.bitmap.format; }
+    std::uint32_t GetWidth() const { return mDescriptor->parameters.bitmap.width; }
+    std::uint32_t GetHeight() const { return mDescriptor->parameters.bitmap.height; }
 
     std::span<const std::uint32_t, 256> GetPalette() const;
     std::uint8_t GetPixel(std::uint32_t x, std::uint32_t y) const;
 
+    // Expand palette indices into palette entries, entries are copied as returned by GetPalette().
+    // stride is the distance between rows in out in pixels, defaults to the bitmap width.
+    bool ExpandToRGBA(std::span<std::uint32_t> out, std::uint32_t stride = 0) const;
+    bool ExpandRowToRGBA(std::uint32_t y, std::span<std::uint32_t> out) const;
+
     void BlendBitmap(std::span<const std::uint8_t> pixels, std::uint32_t width, std::uint32_t height);
-    void BlendBitmapBits(std::span<const std::uint8_t> bits, std::uint8_t paletteIdx, std::uint32_t width, std::uint32_t height);
+    // Set all pixels with a set bit to paletteIdx. Bits are packed LSB first, stride is the distance between rows
+    // in bytes and defaults to the packed width. The bits are placed at x/y and clipped against the bitmap.
+    void BlendBitmapBits(std::span<const std::uint8_t> bits, std::uint8_t paletteIdx, std::uint32_t width, std::uint32_t height,
+                         std::int32_t x = 0, std::int32_t y = 0, std::uint32_t stride = 0);
+    // Blend an overlay at x/y, only touches the set pixels using the precomputed runs
+    void BlendOverlay(const BitmapOverlay& overlay, std::int32_t x = 0, std::int32_t y = 0);
 
 protected:
-    std::uint32_t mFormat;
-    std::uint32_t mWidth;
-    std::uint32_t mHeight;
+    // Returns the pixel data following the palette, or an empty span if the data is too small
+    std::span<std::byte> GetPixels();
+    std::span<const std::byte> GetPixels() const;
 };
 
 class SoundResource : public Resource {
 public:
-    SoundResource(std::uint16_t id, std::uint16_t format, std::uint16_t bits, std::uint32_t channels, std::uint32_t frequency, std::vector<std::byte>&& data);
+    SoundResource(const Descriptor& descriptor, std::span<std::byte> data);
     virtual ~SoundResource();
 
-    std::uint16_t GetFormat() const { return mFormat; }
-    std::uint16_t GetBits() const { return mBits; }
-    std::uint32_t GetChannels() const { return mChannels; }
-    std::uint32_t GetFrequency() const { return mFrequency; }
+    static constexpr bool IsType(Type type) { return type == Type::SOUND; }
 
-protected:
-    std::uint16_t mFormat;
-    std::uint16_t mBits;
-    std::uint32_t mChannels;
-    std::uint32_t mFrequency;
+    std::uint16_t GetFormat() const { return mDescriptor->parameters.sound.format; }
+    std::uint16_t GetBits() const { return mDescriptor->parameters.sound.bits; }
+    std::uint32_t GetChannels() const { return mDescriptor->parameters.sound.channels; }
+    std::uint32_t GetFrequency() const { return mDescriptor->parameters.sound.frequency; }
 };
 
 class UnknownResource : public Resource {
 public:
-    UnknownResource(Type type, std::uint16_t id, std::vector<std::byte>&& parameters, std::vector<std::byte>&& data);
+    UnknownResource(const Descriptor& descriptor, std::span<std::byte> data);
     virtual ~UnknownResource();
 
-    const std::vector<std::byte>& GetParameters() const { return mParameters; }
+    static constexpr bool IsType(Type type) { return type != Type::BITMAP && type != Type::SOUND; }
+
+    std::span<const std::byte, 12> GetParameters() const { return mDescriptor->parameters.raw; }
+};
+
+// A serialized image split into a list of segments.
+// Segments either point into the section buffers of the firmware they were created from,
+// or into buffers owned by this object. They are only valid as long as the firmware is alive and unmodified.
+class FirmwareSegments {
+public:
+    FirmwareSegments();
+    FirmwareSegments(const FirmwareSegments&) = delete;
+    FirmwareSegments(FirmwareSegments&&) = default;
+    virtual ~FirmwareSegments();
+
+    FirmwareSegments& operator=(const FirmwareSegments&) = delete;
+    FirmwareSegments& operator=(FirmwareSegments&&) = default;
+
+    // Append a segment referencing memory which isn't owned by this object
+    void Append(std::span<const std::byte> segment);
+    // Append a segment of the specified size owned by this object, returns the buffer to fill in
+    std::span<std::byte> Append(std::size_t size);
+
+    std::size_t GetSize() const;
+
+    std::span<const std::span<const std::byte>> GetSegments() const { return mSegments; }
+
+    auto begin() const { return mSegments.begin(); }
+    auto end() const { return mSegments.end(); }
 
 protected:
-    std::vector<std::byte> mParameters;
+    std::vector<std::vector<std::byte>> mBuffers;
+    std::vector<std::span<const std::byte>> mSegments;
 };
 
 class FirmwareSection {
@@ -114,6 +203,13 @@ public:
 
     virtual std::vector<std::byte> ToBytes() const = 0;
 
+    // Size of the packed section data in bytes
+    virtual std::size_t SerializedSize() const = 0;
+    // Pack the section data into out, which must be exactly SerializedSize() bytes
+    virtual void SerializeInto(std::span<std::byte> out) const = 0;
+    // Append the section data to segments, by default this serializes into a buffer owned by segments
+    virtual void SerializeSegments(FirmwareSegments& segments) const;
+
     const std::array<char, 4>& GetName() const { return mName; }
     std::uint32_t GetVersion() const { return mVersion; }
 
@@ -135,21 +231,39 @@ public:
     static std::shared_ptr<ResourceSection> FromBytes(const std::array<char, 4>& name, std::uint32_t version, std::span<const std::byte> bytes);
     std::vector<std::byte> ToBytes() const override;
 
-    std::shared_ptr<Resource> GetResource(std::uint16_t id);
-    template<ResourceConcept T>
-    std::shared_ptr<T> GetResource(std::uint16_t id)
+    std::size_t SerializedSize() const override;
+    void SerializeInto(std::span<std::byte> out) const override;
+
+    template<ResourceConcept T = Resource>
+    std::optional<T> GetResource(std::uint16_t id)
+    {
+        const Resource::Descriptor* descriptor = FindDescriptor(id);
+        if (!descriptor || !T::IsType(descriptor->type)) {
+            return std::nullopt;
+        }
+
+        return T(*descriptor, std::span(mArena).subspan(descriptor->offset, descriptor->size));
+    }
+
+    std::span<const std::byte> GetResourceData(const Resource::Descriptor& descriptor) const
     {
-        return std::dynamic_pointer_cast<T>(GetResource(id));
+        return std::span(mArena).subspan(descriptor.offset, descriptor.size);
     }
 
-    // Allow iterating over resources in section
-    auto begin() { return mResources.begin(); }
-    auto end() { return mResources.end(); }
-    auto begin() const { return mResources.begin(); }
-    auto end() const { return mResources.end(); }
+    // Allow iterating over resource descriptors in section
+    auto begin() const { return mDescriptors.cbegin(); }
+    auto end() const { return mDescriptors.cend(); }
 
 protected:
-    std::vector<std::shared_ptr<Resource>> mResources;
+    static constexpr std::size_t ARENA_ALIGNMENT = 4;
+
+    const Resource::Descriptor* FindDescriptor(std::uint16_t id) const;
+
+    // All resource data is stored in a single arena, the descriptors point into it
+    std::vector<Resource::Descriptor> mDescriptors;
+    std::vector<std::byte> mArena;
+    // Total size of the resource data without arena padding
+    std::size_t mDataSize;
 };
 
 class GenericSection : public FirmwareSection {
@@ -158,6 +272,16 @@ public:
     virtual ~GenericSection();
 
     std::vector<std::byte> ToBytes() const override { return mData; };
+    std::span<const std::byte> GetData() const { return mData; }
+
+    // CRC of the section data, cached until the data is modified
+    std::uint32_t GetCRC() const;
+    // CRCs of the whole pages in the section when placed at offset in the payload, cached until the data is modified
+    std::span<const std::uint32_t> GetPageCRCs(std::size_t offset) const;
+
+    std::size_t SerializedSize() const override { return mData.size(); }
+    void SerializeInto(std::span<std::byte> out) const override;
+    void SerializeSegments(FirmwareSegments& segments) const override;
 
     void WriteAt(std::size_t offset, std::span<const std::byte> data);
     template<std::integral T>
@@ -171,7 +295,13 @@ public:
     }
 
 protected:
+    friend class Firmware;
+
     std::vector<std::byte> mData;
+
+    mutable std::optional<std::uint32_t> mCRC;
+    mutable std::optional<std::size_t> mPageCRCAlignment;
+    mutable std::vector<std::uint32_t> mPageCRCs;
 };
 
 template <typename T>
@@ -184,6 +314,10 @@ public:
         DRH = 0x00010000,
     };
 
+    static constexpr std::size_t HEADER_SIZE = 0x1000;
+    static constexpr std::size_t SUB_CRC_TABLE_SIZE = 0x4000;
+    static constexpr std::size_t PAGE_SIZE = 0x1000;
+
     struct Header {
         Type type;
         std::array<std::uint32_t, 4> superCRCs;
@@ -193,11 +327,22 @@ public:
     };
 
     Firmware();
+    Firmware(const Firmware&) = default;
+    Firmware(Firmware&&) = default;
     virtual ~Firmware();
 
+    Firmware& operator=(const Firmware&) = default;
+    Firmware& operator=(Firmware&&) = default;
+
     static std::expected<Firmware, std::string> FromStream(Stream& stream);
+    // Verify the header and every page against its sub CRC in a single pass, without unpacking any sections
+    static std::expected<void, std::string> Verify(Stream& stream);
     std::vector<std::byte> ToBytes() const;
 
+    std::size_t SerializedSize() const;
+    void SerializeInto(std::span<std::byte> out) const;
+    void SerializeSegments(FirmwareSegments& segments) const;
+
     std::shared_ptr<FirmwareSection> GetSection(std::string name);
     template<SectionConcept T>
     std::shared_ptr<T> GetSection(std::string name)
@@ -205,6 +350,11 @@ public:
         return std::dynamic_pointer_cast<T>(GetSection(name));
     }
 
+    // CRCs of every page of section data and the section headers as they were parsed.
+    // These describe the image the firmware was loaded from and are empty for firmware which wasn't parsed.
+    std::span<const std::uint32_t> GetPageCRCs() const { return mPageCRCs; }
+    std::span<const FirmwareSection::Header> GetSectionHeaders() const { return mSectionHeaders; }
+
     // Allow iterating over sections in firmware
     auto begin() { return mSections.begin(); }
     auto end() { return mSections.end(); }
@@ -215,20 +365,62 @@ protected:
     bool UnpackHeader(Stream& stream);
     bool UnpackSections(Stream& stream);
 
-    std::vector<std::byte> PackSections() const;
+    std::size_t PackedSectionsSize() const;
+    void PackSections(std::span<std::byte> out) const;
+    void PackSectionHeaders(std::span<std::byte> out) const;
+    std::vector<std::optional<std::uint32_t>> GetKnownPageCRCs() const;
+    void PackHeader(std::span<std::byte> header, std::span<std::byte> subCRCData, std::span<const std::span<const std::byte>> sectionData) const;
 
     Type mType;
     std::vector<std::shared_ptr<FirmwareSection>> mSections;
+
+    std::vector<std::uint32_t> mPageCRCs;
+    std::vector<FirmwareSection::Header> mSectionHeaders;
 };
 
 class FirmwareBlob {
 public:
     FirmwareBlob();
+    FirmwareBlob(const FirmwareBlob&) = default;
+    FirmwareBlob(FirmwareBlob&&) = default;
     virtual ~FirmwareBlob();
 
+    FirmwareBlob& operator=(const FirmwareBlob&) = default;
+    FirmwareBlob& operator=(FirmwareBlob&&) = default;
+
+    static constexpr std::size_t HEADER_SIZE = 0x10;
+
+    // Header information of an image, see Peek
+    struct PeekResult {
+        std::uint32_t imageVersion;
+        std::uint32_t blockSize;
+        std::uint32_t sequencePerSession;
+        std::uint32_t imageSize;
+
+        Firmware::Type type;
+        bool headerCRCValid;
+        bool superCRCsValid;
+
+        // Section headers from the INDX section, including INDX itself
+        std::vector<FirmwareSection::Header> sections;
+        // Sub-CRC of every page, not verified against the page data
+        std::vector<std::uint32_t> pageCRCs;
+    };
+
+    // Read only the headers, the sub-CRC table and the INDX section of an image, without touching the section data.
+    // Fails if the image is truncated or the INDX section is malformed, CRC validity is reported in the result.
+    static std::expected<PeekResult, std::string> Peek(Stream& stream);
+
     static std::expected<FirmwareBlob, std::string> FromStream(Stream& stream);
+    // Verify all CRCs of an image like FromStream does, but only keeps a single page in memory
+    static std::expected<void, std::string> Verify(Stream& stream);
     std::vector<std::byte> ToBytes() const;
 
+    std::size_t SerializedSize() const;
+    void SerializeInto(std::span<std::byte> out) const;
+    // Serialize without copying section data, see FirmwareSegments
+    FirmwareSegments ToSegments() const;
+
     std::uint32_t GetImageVersion() const { return mImageVersion; }
     std::uint32_t GetBlockSize() const { return mBlockSize; }
     std::uint32_t GetSequencePerSession() const { return mSequencePerSession; }
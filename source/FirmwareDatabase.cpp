@@ -0,0 +1,95 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "FirmwareDatabase.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+
+// Entries can be generated from firmware dumps with "drxfw fingerprint",
+// the section fingerprints of a build are kept in a separate array the entry points to
+const std::vector<FirmwareDatabase::Build> kBuilds = {
+};
+
+}
+
+namespace FirmwareDatabase
+{
+
+std::vector<SectionFingerprint> Fingerprint(std::span<const FirmwareSection::Header> sections, std::span<const std::uint32_t> pageCRCs)
+{
+    std::vector<SectionFingerprint> fingerprints;
+    for (const FirmwareSection::Header& section : sections) {
+        if (std::memcmp(section.name.data(), "INDX", 4u) == 0) {
+            continue;
+        }
+
+        // Pages at the section borders are shared with the neighbouring sections,
+        // which is fine since they're the same for every image of a build
+        const std::size_t firstPage = section.offset / Firmware::PAGE_SIZE;
+        const std::size_t endPage = std::min<std::size_t>((std::size_t(section.offset) + section.size + Firmware::PAGE_SIZE - 1) / Firmware::PAGE_SIZE, pageCRCs.size());
+
+        // Hash the CRCs as they're stored in the header, so the result doesn't depend on the host
+        std::uint32_t crc = 0;
+        for (std::size_t page = firstPage; page < endPage; page++) {
+            std::array<std::byte, sizeof(std::uint32_t)> bytes;
+            MutableSpanStream stream(bytes, std::endian::little);
+            stream << pageCRCs[page];
+            crc = Utils::crc32(bytes, crc);
+        }
+
+        fingerprints.push_back({ section.name, crc });
+    }
+
+    return fingerprints;
+}
+
+std::span<const Build> GetBuilds()
+{
+    return kBuilds;
+}
+
+const Build* Identify(std::uint32_t imageVersion, std::span<const SectionFingerprint> fingerprints)
+{
+    return Identify(imageVersion, fingerprints, kBuilds);
+}
+
+const Build* Identify(std::uint32_t imageVersion, std::span<const SectionFingerprint> fingerprints, std::span<const Build> builds)
+{
+    for (const Build& build : builds) {
+        // An entry without fingerprints would match every image with its version
+        if (build.imageVersion != imageVersion || build.sections.empty()) {
+            continue;
+        }
+
+        const bool matches = std::ranges::all_of(build.sections, [&fingerprints](const SectionFingerprint& expected) {
+            return std::ranges::any_of(fingerprints, [&expected](const SectionFingerprint& fingerprint) {
+                return fingerprint.name == expected.name && fingerprint.crc == expected.crc;
+            });
+        });
+        if (matches) {
+            return std::addressof(build);
+        }
+    }
+
+    return nullptr;
+}
+
+}
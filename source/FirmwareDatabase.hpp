@@ -0,0 +1,56 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "Firmware.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Identifies known firmware builds from the sub-CRC table in the firmware header,
+// so an image can be identified without reading any section data
+namespace FirmwareDatabase
+{
+
+struct SectionFingerprint {
+    std::array<char, 4> name;
+    // CRC over the sub-CRCs of all pages the section touches
+    std::uint32_t crc;
+};
+
+struct Build {
+    const char* name;
+    const char* region;
+    std::uint32_t imageVersion;
+    // All of these sections have to match, sections which aren't listed are ignored
+    std::span<const SectionFingerprint> sections;
+};
+
+// Fingerprints of all sections except INDX, in the order of the section headers
+std::vector<SectionFingerprint> Fingerprint(std::span<const FirmwareSection::Header> sections, std::span<const std::uint32_t> pageCRCs);
+
+// All builds in the database
+std::span<const Build> GetBuilds();
+
+// Look up the build matching the fingerprints, returns nullptr for unknown builds.
+// Builds without any section fingerprints never match.
+const Build* Identify(std::uint32_t imageVersion, std::span<const SectionFingerprint> fingerprints);
+// Same as above, but looks up the build in builds instead of the database
+const Build* Identify(std::uint32_t imageVersion, std::span<const SectionFingerprint> fingerprints, std::span<const Build> builds);
+
+}
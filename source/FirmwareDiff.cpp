@@ -0,0 +1,224 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "FirmwareDiff.hpp"
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+namespace
+{
+
+// Append ranges of differing bytes between a and b, offset is the position of a and b in the section
+void AppendRanges(std::vector<FirmwareDiff::Range>& ranges, std::span<const std::byte> a, std::span<const std::byte> b, std::size_t offset)
+{
+    std::size_t i = 0;
+    while (i < a.size()) {
+        auto [first, _] = std::mismatch(a.begin() + i, a.end(), b.begin() + i);
+        if (first == a.end()) {
+            break;
+        }
+
+        const std::size_t start = first - a.begin();
+        std::size_t end = start;
+        while (end < a.size() && a[end] != b[end]) {
+            end++;
+        }
+
+        // Ranges continuing across a page boundary are merged
+        if (!ranges.empty() && ranges.back().offset + ranges.back().size == offset + start) {
+            ranges.back().size += end - start;
+        } else {
+            ranges.push_back({offset + start, end - start});
+        }
+        i = end;
+    }
+}
+
+// Section data as it was stored in the image, resource sections need to be packed
+class SectionBytes {
+public:
+    SectionBytes(const FirmwareSection& section) : mSection(section) {}
+
+    std::span<const std::byte> Get()
+    {
+        if (auto generic = dynamic_cast<const GenericSection*>(&mSection)) {
+            return generic->GetData();
+        }
+
+        if (!mPacked) {
+            mPacked = mSection.ToBytes();
+        }
+        return *mPacked;
+    }
+
+private:
+    const FirmwareSection& mSection;
+    std::optional<std::vector<std::byte>> mPacked;
+};
+
+std::vector<FirmwareDiff::ResourceChange> CompareResources(const ResourceSection& oldSection, const ResourceSection& newSection)
+{
+    std::vector<const Resource::Descriptor*> oldResources;
+    std::vector<const Resource::Descriptor*> newResources;
+    for (const Resource::Descriptor& descriptor : oldSection) {
+        oldResources.push_back(&descriptor);
+    }
+    for (const Resource::Descriptor& descriptor : newSection) {
+        newResources.push_back(&descriptor);
+    }
+
+    const auto byID = [](const Resource::Descriptor* a, const Resource::Descriptor* b) { return a->id < b->id; };
+    std::sort(oldResources.begin(), oldResources.end(), byID);
+    std::sort(newResources.begin(), newResources.end(), byID);
+
+    // Walk both sorted lists at once
+    std::vector<FirmwareDiff::ResourceChange> changes;
+    auto oldIt = oldResources.begin();
+    auto newIt = newResources.begin();
+    while (oldIt != oldResources.end() || newIt != newResources.end()) {
+        if (newIt == newResources.end() || (oldIt != oldResources.end() && (*oldIt)->id < (*newIt)->id)) {
+            changes.push_back({FirmwareDiff::ResourceChange::Kind::REMOVED, (*oldIt)->id});
+            oldIt++;
+        } else if (oldIt == oldResources.end() || (*newIt)->id < (*oldIt)->id) {
+            changes.push_back({FirmwareDiff::ResourceChange::Kind::ADDED, (*newIt)->id});
+            newIt++;
+        } else {
+            const Resource::Descriptor& oldDescriptor = **oldIt;
+            const Resource::Descriptor& newDescriptor = **newIt;
+            const std::span<const std::byte> oldData = oldSection.GetResourceData(oldDescriptor);
+            const std::span<const std::byte> newData = newSection.GetResourceData(newDescriptor);
+            if (oldDescriptor.type != newDescriptor.type ||
+                oldDescriptor.parameters.raw != newDescriptor.parameters.raw ||
+                !std::ranges::equal(oldData, newData)) {
+                changes.push_back({FirmwareDiff::ResourceChange::Kind::CHANGED, oldDescriptor.id});
+            }
+            oldIt++;
+            newIt++;
+        }
+    }
+
+    return changes;
+}
+
+}
+
+FirmwareDiff::FirmwareDiff()
+ : mSections(),
+   mSkippedPages(0),
+   mComparedPages(0)
+{
+}
+
+FirmwareDiff::~FirmwareDiff()
+{
+}
+
+FirmwareDiff FirmwareDiff::Compare(const Firmware& oldFirmware, const Firmware& newFirmware)
+{
+    FirmwareDiff diff;
+
+    const auto oldSections = std::span(oldFirmware.begin(), oldFirmware.end());
+    const auto newSections = std::span(newFirmware.begin(), newFirmware.end());
+    std::vector<bool> matched(newSections.size());
+
+    for (std::size_t i = 0; i < oldSections.size(); i++) {
+        SectionDiff& section = diff.mSections.emplace_back();
+        section.name = oldSections[i]->GetName();
+        section.oldSize = oldSections[i]->SerializedSize();
+        section.newSize = 0;
+
+        // Match sections by name, each new section is only matched once.
+        // INDX is compared like every other section, so changed section headers show up as changed INDX ranges.
+        auto it = std::find_if(newSections.begin(), newSections.end(), [&](const auto& newSection) {
+            return newSection->GetName() == section.name && !matched[&newSection - newSections.data()];
+        });
+        if (it == newSections.end()) {
+            section.status = SectionDiff::Status::REMOVED;
+            continue;
+        }
+
+        const std::size_t newIndex = it - newSections.begin();
+        matched[newIndex] = true;
+        section.newSize = (*it)->SerializedSize();
+        diff.CompareSection(section, oldFirmware, i, newFirmware, newIndex);
+    }
+
+    for (std::size_t i = 0; i < newSections.size(); i++) {
+        if (!matched[i]) {
+            SectionDiff& section = diff.mSections.emplace_back();
+            section.name = newSections[i]->GetName();
+            section.status = SectionDiff::Status::ADDED;
+            section.oldSize = 0;
+            section.newSize = newSections[i]->SerializedSize();
+        }
+    }
+
+    return diff;
+}
+
+void FirmwareDiff::CompareSection(SectionDiff& diff, const Firmware& oldFirmware, std::size_t oldIndex, const Firmware& newFirmware, std::size_t newIndex)
+{
+    const FirmwareSection& oldSection = **(oldFirmware.begin() + oldIndex);
+    const FirmwareSection& newSection = **(newFirmware.begin() + newIndex);
+    SectionBytes oldBytes(oldSection);
+    SectionBytes newBytes(newSection);
+
+    const std::size_t commonSize = std::min(diff.oldSize, diff.newSize);
+    const auto oldHeaders = oldFirmware.GetSectionHeaders();
+    const auto newHeaders = newFirmware.GetSectionHeaders();
+    const auto oldCRCs = oldFirmware.GetPageCRCs();
+    const auto newCRCs = newFirmware.GetPageCRCs();
+
+    // Pages can only be skipped if the section starts at the same offset in both images
+    std::optional<std::size_t> sectionOffset;
+    if (oldIndex < oldHeaders.size() && newIndex < newHeaders.size() &&
+        oldHeaders[oldIndex].offset == newHeaders[newIndex].offset) {
+        sectionOffset = oldHeaders[oldIndex].offset;
+    }
+
+    std::size_t position = 0;
+    while (position < commonSize) {
+        std::size_t end = commonSize;
+        if (sectionOffset) {
+            const std::size_t page = (*sectionOffset + position) / Firmware::PAGE_SIZE;
+            end = std::min((page + 1) * Firmware::PAGE_SIZE - *sectionOffset, commonSize);
+
+            if (page < oldCRCs.size() && page < newCRCs.size() && oldCRCs[page] == newCRCs[page]) {
+                mSkippedPages++;
+                position = end;
+                continue;
+            }
+        }
+
+        mComparedPages++;
+        AppendRanges(diff.ranges, oldBytes.Get().subspan(position, end - position), newBytes.Get().subspan(position, end - position), position);
+        position = end;
+    }
+
+    // Anything past the end of the smaller section counts as changed
+    if (diff.oldSize != diff.newSize) {
+        diff.ranges.push_back({commonSize, std::max(diff.oldSize, diff.newSize) - commonSize});
+    }
+
+    auto oldResources = dynamic_cast<const ResourceSection*>(&oldSection);
+    auto newResources = dynamic_cast<const ResourceSection*>(&newSection);
+    if (oldResources && newResources && !diff.ranges.empty()) {
+        diff.resources = CompareResources(*oldResources, *newResources);
+    }
+
+    diff.status = diff.ranges.empty() ? SectionDiff::Status::SAME : SectionDiff::Status::CHANGED;
+}
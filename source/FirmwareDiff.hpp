@@ -0,0 +1,80 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "Firmware.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Section and resource level differences between two parsed firmware images.
+// Pages with matching CRCs in both images are assumed identical and skipped, so the
+// firmware has to be unmodified since parsing for the page CRCs to be meaningful.
+class FirmwareDiff {
+public:
+    // Range of changed bytes, relative to the start of the section
+    struct Range {
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    struct ResourceChange {
+        enum class Kind {
+            ADDED,
+            REMOVED,
+            CHANGED,
+        };
+
+        Kind kind;
+        std::uint16_t id;
+    };
+
+    struct SectionDiff {
+        enum class Status {
+            SAME,
+            CHANGED,
+            ADDED,
+            REMOVED,
+        };
+
+        std::array<char, 4> name;
+        Status status;
+        std::size_t oldSize;
+        std::size_t newSize;
+        std::vector<Range> ranges;
+        // Only filled for resource sections
+        std::vector<ResourceChange> resources;
+    };
+
+    FirmwareDiff();
+    virtual ~FirmwareDiff();
+
+    static FirmwareDiff Compare(const Firmware& oldFirmware, const Firmware& newFirmware);
+
+    const std::vector<SectionDiff>& GetSections() const { return mSections; }
+
+    // Amount of pages skipped because of matching CRCs and pages which had to be compared byte by byte
+    std::size_t GetSkippedPages() const { return mSkippedPages; }
+    std::size_t GetComparedPages() const { return mComparedPages; }
+
+protected:
+    void CompareSection(SectionDiff& diff, const Firmware& oldFirmware, std::size_t oldIndex, const Firmware& newFirmware, std::size_t newIndex);
+
+    std::vector<SectionDiff> mSections;
+    std::size_t mSkippedPages;
+    std::size_t mComparedPages;
+};
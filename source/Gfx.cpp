@@ -254,6 +254,49 @@ int GetIconWidth(int size, Uint16 icon)
     return (int) (((float) w / h) * size);
 }
 
+SDL_Texture* CreateTexture(int w, int h, const uint32_t* pixels, int stride)
+{
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, w, h);
+    if (!texture) {
+        return nullptr;
+    }
+
+    if (SDL_UpdateTexture(texture, nullptr, pixels, stride * sizeof(uint32_t)) != 0) {
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+void DestroyTexture(SDL_Texture* texture)
+{
+    SDL_DestroyTexture(texture);
+}
+
+void DrawTexture(int x, int y, SDL_Texture* texture, AlignFlags align)
+{
+    SDL_Rect rect;
+    rect.x = x;
+    rect.y = y;
+    SDL_QueryTexture(texture, nullptr, nullptr, &rect.w, &rect.h);
+
+    if (align & ALIGN_RIGHT) {
+        rect.x -= rect.w;
+    } else if (align & ALIGN_HORIZONTAL) {
+        rect.x -= rect.w / 2;
+    }
+
+    if (align & ALIGN_BOTTOM) {
+        rect.y -= rect.h;
+    } else if (align & ALIGN_VERTICAL) {
+        rect.y -= rect.h / 2;
+    }
+
+    SDL_RenderCopy(renderer, texture, nullptr, &rect);
+}
+
 void Print(int x, int y, int size, SDL_Color color, std::string text, AlignFlags align, bool monospace)
 {
     FC_Font* font = monospace ? monospaceFont : GetFontForSize(size);
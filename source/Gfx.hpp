@@ -76,6 +76,14 @@ int GetIconWidth(int size, Uint16 icon);
 
 static inline int GetIconHeight(int size, Uint16 icon) { return size; }
 
+// Create a static texture from RGBA pixels, stride is the distance between rows in pixels
+SDL_Texture* CreateTexture(int w, int h, const uint32_t* pixels, int stride);
+
+void DestroyTexture(SDL_Texture* texture);
+
+// Draw a texture at its original size
+void DrawTexture(int x, int y, SDL_Texture* texture, AlignFlags align = ALIGN_LEFT | ALIGN_TOP);
+
 void Print(int x, int y, int size, SDL_Color color, std::string text, AlignFlags align = ALIGN_LEFT | ALIGN_TOP, bool monospace = false);
 
 int GetTextWidth(int size, std::string text, bool monospace = false);
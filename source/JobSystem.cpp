@@ -0,0 +1,294 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "JobSystem.hpp"
+#include <algorithm>
+
+#ifdef __WIIU__
+#include <coreinit/debug.h>
+#include <coreinit/thread.h>
+#include <cstdint>
+#include <malloc.h>
+#else
+#include <thread>
+#endif
+
+class JobSystem::Worker {
+public:
+    using Main = void (JobSystem::*)(std::size_t index);
+
+    Worker(JobSystem& system, std::size_t index, Main main, const char* name);
+    ~Worker();
+
+    bool IsCurrentThread() const;
+
+    std::mutex mutex;
+    // The owning worker takes jobs from the back, others steal from the front
+    std::deque<Job> jobs;
+
+private:
+#ifdef __WIIU__
+    static int ThreadEntry(int argc, const char** argv);
+
+    static constexpr std::uint32_t STACK_SIZE = 0x20000;
+
+    JobSystem& mSystem;
+    std::size_t mIndex;
+    Main mMain;
+    OSThread* mThread;
+    void* mStack;
+#else
+    std::thread mThread;
+#endif
+};
+
+#ifdef __WIIU__
+JobSystem::Worker::Worker(JobSystem& system, std::size_t index, Main main, const char* name)
+ : mSystem(system), mIndex(index), mMain(main), mThread(nullptr), mStack(nullptr)
+{
+    mThread = static_cast<OSThread*>(memalign(16, sizeof(OSThread)));
+    mStack = memalign(16, STACK_SIZE);
+
+    // Keep the workers off core 1, which runs the UI
+    OSThreadAttributes affinity = (index % 2) ? OS_THREAD_ATTRIB_AFFINITY_CPU2 : OS_THREAD_ATTRIB_AFFINITY_CPU0;
+    if (!OSCreateThread(mThread, &Worker::ThreadEntry, 0, reinterpret_cast<char*>(this),
+        static_cast<std::uint8_t*>(mStack) + STACK_SIZE, STACK_SIZE, 16, affinity)) {
+        OSFatal("DRXUtil: Failed to create job system worker");
+    }
+
+    OSSetThreadName(mThread, name);
+    OSResumeThread(mThread);
+}
+
+JobSystem::Worker::~Worker()
+{
+    OSJoinThread(mThread, nullptr);
+    free(mThread);
+    free(mStack);
+}
+
+bool JobSystem::Worker::IsCurrentThread() const
+{
+    return OSGetCurrentThread() == mThread;
+}
+
+int JobSystem::Worker::ThreadEntry(int argc, const char** argv)
+{
+    Worker* worker = reinterpret_cast<Worker*>(argv);
+    (worker->mSystem.*worker->mMain)(worker->mIndex);
+    return 0;
+}
+#else
+JobSystem::Worker::Worker(JobSystem& system, std::size_t index, Main main, const char* name)
+ : mThread()
+{
+    mThread = std::thread(main, &system, index);
+}
+
+JobSystem::Worker::~Worker()
+{
+    mThread.join();
+}
+
+bool JobSystem::Worker::IsCurrentThread() const
+{
+    return std::this_thread::get_id() == mThread.get_id();
+}
+#endif
+
+JobSystem::JobSystem(std::size_t workerCount)
+ : mWorkers(),
+   mNextWorker(0),
+   mQueuedJobs(0),
+   mPendingJobs(0),
+   mStopping(false),
+   mBlockingWorker(),
+   mBlockingJobs(),
+   mBlockingStopping(false)
+{
+    if (workerCount == 0) {
+#ifdef __WIIU__
+        workerCount = 2;
+#else
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+#endif
+    }
+
+    // Workers may start stealing right away, so the list has to be complete before the first one starts
+    mWorkers.resize(workerCount);
+    std::lock_guard lock(mMutex);
+    for (std::size_t i = 0; i < workerCount; i++) {
+        mWorkers[i] = std::make_unique<Worker>(*this, i, &JobSystem::WorkerMain, "DRXUtil Job Worker");
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    // The blocking worker may still queue continuations, so it has to finish before the other workers stop
+    {
+        std::lock_guard lock(mMutex);
+        mBlockingStopping = true;
+    }
+    mBlockingJobAvailable.notify_all();
+    mBlockingWorker.reset();
+
+    {
+        std::lock_guard lock(mMutex);
+        mStopping = true;
+    }
+    mJobAvailable.notify_all();
+
+    // Workers finish all queued jobs before they exit
+    mWorkers.clear();
+}
+
+JobSystem& JobSystem::GetDefault()
+{
+    static JobSystem jobSystem;
+    return jobSystem;
+}
+
+void JobSystem::Wait()
+{
+    std::unique_lock lock(mMutex);
+    mJobsDone.wait(lock, [this]() { return mPendingJobs == 0; });
+}
+
+void JobSystem::Push(Job job)
+{
+    // Jobs submitted from a worker stay on that worker, others are distributed round robin
+    std::size_t index = mNextWorker++ % mWorkers.size();
+    for (std::size_t i = 0; i < mWorkers.size(); i++) {
+        if (mWorkers[i]->IsCurrentThread()) {
+            index = i;
+            break;
+        }
+    }
+
+    {
+        std::lock_guard lock(mWorkers[index]->mutex);
+        mWorkers[index]->jobs.push_back(std::move(job));
+    }
+
+    {
+        std::lock_guard lock(mMutex);
+        mQueuedJobs++;
+        mPendingJobs++;
+    }
+    mJobAvailable.notify_one();
+}
+
+bool JobSystem::TryPop(std::size_t index, Job& job)
+{
+    {
+        Worker& worker = *mWorkers[index];
+        std::lock_guard lock(worker.mutex);
+        if (!worker.jobs.empty()) {
+            job = std::move(worker.jobs.back());
+            worker.jobs.pop_back();
+            return true;
+        }
+    }
+
+    for (std::size_t i = 1; i < mWorkers.size(); i++) {
+        Worker& victim = *mWorkers[(index + i) % mWorkers.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::WorkerMain(std::size_t index)
+{
+    {
+        // Wait until the constructor has created all workers
+        std::lock_guard lock(mMutex);
+    }
+
+    while (true) {
+        {
+            std::unique_lock lock(mMutex);
+            mJobAvailable.wait(lock, [this]() { return mStopping || mQueuedJobs > 0; });
+            if (mQueuedJobs == 0) {
+                return;
+            }
+
+            // Claiming a job here guarantees there is one left in one of the queues
+            mQueuedJobs--;
+        }
+
+        Job job;
+        while (!TryPop(index, job)) {
+            // Another worker took the job this one was going for, but there is another one left somewhere
+        }
+
+        job();
+        job = nullptr;
+
+        FinishJob();
+    }
+}
+
+void JobSystem::FinishJob()
+{
+    std::lock_guard lock(mMutex);
+    mPendingJobs--;
+    if (mPendingJobs == 0) {
+        mJobsDone.notify_all();
+    }
+}
+
+void JobSystem::PushBlocking(Job job)
+{
+    {
+        std::lock_guard lock(mMutex);
+        if (!mBlockingWorker) {
+            // Index 0 keeps it on the same core as the first regular worker on the Wii U, it's asleep most of the time
+            mBlockingWorker = std::make_unique<Worker>(*this, 0, &JobSystem::BlockingWorkerMain, "DRXUtil Blocking Job Worker");
+        }
+
+        mBlockingJobs.push_back(std::move(job));
+        mPendingJobs++;
+    }
+    mBlockingJobAvailable.notify_one();
+}
+
+void JobSystem::BlockingWorkerMain(std::size_t index)
+{
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(mMutex);
+            mBlockingJobAvailable.wait(lock, [this]() { return mBlockingStopping || !mBlockingJobs.empty(); });
+            if (mBlockingJobs.empty()) {
+                return;
+            }
+
+            job = std::move(mBlockingJobs.front());
+            mBlockingJobs.pop_front();
+        }
+
+        job();
+        job = nullptr;
+
+        FinishJob();
+    }
+}
@@ -0,0 +1,242 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class JobSystem;
+
+// Result type of a continuation called with the result of a job returning T
+template<typename F, typename T>
+struct JobContinuationResult {
+    using type = std::invoke_result_t<F, T&>;
+};
+
+template<typename F>
+struct JobContinuationResult<F, void> {
+    using type = std::invoke_result_t<F>;
+};
+
+// Result of a job submitted to a JobSystem
+template<typename T>
+class JobFuture {
+private:
+    struct Empty {};
+    using Storage = std::conditional_t<std::is_void_v<T>, Empty, T>;
+
+    struct State {
+        JobSystem* system;
+        std::mutex mutex;
+        std::condition_variable done;
+        bool ready = false;
+        Storage value{};
+        std::vector<std::function<void(void)>> continuations;
+    };
+
+public:
+    JobFuture() = default;
+
+    bool IsValid() const { return mState != nullptr; }
+
+    bool IsReady() const
+    {
+        std::lock_guard lock(mState->mutex);
+        return mState->ready;
+    }
+
+    // Block until the job has finished, this must not be called from inside another job
+    void Wait() const
+    {
+        std::unique_lock lock(mState->mutex);
+        mState->done.wait(lock, [this]() { return mState->ready; });
+    }
+
+    // Wait for the job and return its result
+    T Get() const
+    {
+        Wait();
+        if constexpr (!std::is_void_v<T>) {
+            return mState->value;
+        }
+    }
+
+    // Submit function as a new job once this one has finished, the result is passed to function
+    template<typename F>
+    auto Then(F&& function) const;
+
+private:
+    friend class JobSystem;
+    template<typename U> friend class JobFuture;
+
+    explicit JobFuture(std::shared_ptr<State> state) : mState(std::move(state)) {}
+
+    std::shared_ptr<State> mState;
+};
+
+// Fixed size pool of workers, each worker has its own job queue and steals from the others once it runs empty.
+// On the Wii U the workers run on core 0 and 2, the UI keeps core 1 for itself.
+class JobSystem {
+public:
+    using Job = std::function<void(void)>;
+
+    // Uses the default worker count of the platform if workerCount is 0
+    JobSystem(std::size_t workerCount = 0);
+    virtual ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Shared job system for the whole application, created on first use
+    static JobSystem& GetDefault();
+
+    template<typename F>
+    auto Submit(F&& function) -> JobFuture<std::invoke_result_t<std::decay_t<F>>>
+    {
+        auto [job, future] = MakeJob(std::forward<F>(function));
+        Push(std::move(job));
+        return future;
+    }
+
+    // Submit a job which spends most of its time waiting, like flashing the DRC.
+    // These run one after another on a separate worker, so they don't hold up the other jobs.
+    // Continuations are run by the regular workers.
+    template<typename F>
+    auto SubmitBlocking(F&& function) -> JobFuture<std::invoke_result_t<std::decay_t<F>>>
+    {
+        auto [job, future] = MakeJob(std::forward<F>(function));
+        PushBlocking(std::move(job));
+        return future;
+    }
+
+    // Wait until all submitted jobs and their continuations have finished
+    void Wait();
+
+    std::size_t GetWorkerCount() const { return mWorkers.size(); }
+
+private:
+    template<typename U> friend class JobFuture;
+
+    class Worker;
+
+    template<typename F>
+    auto MakeJob(F&& function) -> std::pair<Job, JobFuture<std::invoke_result_t<std::decay_t<F>>>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        using State = typename JobFuture<Result>::State;
+
+        auto state = std::make_shared<State>();
+        state->system = this;
+        Job job = [state, function = std::forward<F>(function)]() mutable {
+            if constexpr (std::is_void_v<Result>) {
+                function();
+                Complete<Result>(*state, {});
+            } else {
+                Complete<Result>(*state, function());
+            }
+        };
+
+        return { std::move(job), JobFuture<Result>(std::move(state)) };
+    }
+
+    template<typename T>
+    static void Complete(typename JobFuture<T>::State& state, typename JobFuture<T>::Storage&& value)
+    {
+        std::vector<Job> continuations;
+        {
+            std::lock_guard lock(state.mutex);
+            state.value = std::move(value);
+            state.ready = true;
+            continuations.swap(state.continuations);
+        }
+        state.done.notify_all();
+
+        for (Job& continuation : continuations) {
+            state.system->Push(std::move(continuation));
+        }
+    }
+
+    void Push(Job job);
+    bool TryPop(std::size_t index, Job& job);
+    void WorkerMain(std::size_t index);
+    void FinishJob();
+
+    void PushBlocking(Job job);
+    void BlockingWorkerMain(std::size_t index);
+
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+    std::atomic<std::size_t> mNextWorker;
+
+    std::mutex mMutex;
+    std::condition_variable mJobAvailable;
+    std::condition_variable mJobsDone;
+    // Jobs waiting in any of the queues
+    std::size_t mQueuedJobs;
+    // Queued and running jobs
+    std::size_t mPendingJobs;
+    bool mStopping;
+
+    // Created on the first blocking job, its queue is protected by mMutex
+    std::unique_ptr<Worker> mBlockingWorker;
+    std::deque<Job> mBlockingJobs;
+    std::condition_variable mBlockingJobAvailable;
+    bool mBlockingStopping;
+};
+
+template<typename T>
+template<typename F>
+auto JobFuture<T>::Then(F&& function) const
+{
+    using Result = typename JobContinuationResult<std::decay_t<F>, T>::type;
+    using NextState = typename JobFuture<Result>::State;
+
+    auto next = std::make_shared<NextState>();
+    next->system = mState->system;
+    JobSystem::Job continuation = [state = mState, next, function = std::forward<F>(function)]() mutable {
+        if constexpr (std::is_void_v<T> && std::is_void_v<Result>) {
+            function();
+            JobSystem::Complete<Result>(*next, {});
+        } else if constexpr (std::is_void_v<T>) {
+            JobSystem::Complete<Result>(*next, function());
+        } else if constexpr (std::is_void_v<Result>) {
+            function(state->value);
+            JobSystem::Complete<Result>(*next, {});
+        } else {
+            JobSystem::Complete<Result>(*next, function(state->value));
+        }
+    };
+
+    // Run the continuation right away if this job already finished
+    {
+        std::lock_guard lock(mState->mutex);
+        if (!mState->ready) {
+            mState->continuations.push_back(std::move(continuation));
+            return JobFuture<Result>(std::move(next));
+        }
+    }
+
+    mState->system->Push(std::move(continuation));
+    return JobFuture<Result>(std::move(next));
+}
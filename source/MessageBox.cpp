@@ -53,11 +53,12 @@ void MessageBox::Draw()
         }
 
         uint32_t textStart = xOff + (xSize - iconWidth - Gfx::GetTextWidth(64, mOptions[i].text)) / 2;
+        SDL_Color textColor = IsOptionEnabled(i) ? Gfx::COLOR_TEXT : Gfx::COLOR_ALT_TEXT;
 
         if (iconWidth) {
-            Gfx::DrawIcon(textStart, Gfx::SCREEN_HEIGHT - 300 + 64, 64, Gfx::COLOR_TEXT, mOptions[i].icon);
+            Gfx::DrawIcon(textStart, Gfx::SCREEN_HEIGHT - 300 + 64, 64, textColor, mOptions[i].icon);
         }
-        Gfx::Print(textStart + iconWidth, Gfx::SCREEN_HEIGHT - 300 + 64, 64, Gfx::COLOR_TEXT, mOptions[i].text, Gfx::ALIGN_VERTICAL | Gfx::ALIGN_LEFT);
+        Gfx::Print(textStart + iconWidth, Gfx::SCREEN_HEIGHT - 300 + 64, 64, textColor, mOptions[i].text, Gfx::ALIGN_VERTICAL | Gfx::ALIGN_LEFT);
 
         if (i == mSelected) {
             Gfx::DrawRect(xOff, Gfx::SCREEN_HEIGHT - 300, xSize, 128, 8, Gfx::COLOR_HIGHLIGHTED);
@@ -74,6 +75,10 @@ bool MessageBox::Update(const VPADStatus& input)
     }
 
     if (input.trigger & VPAD_BUTTON_A) {
+        if (!IsOptionEnabled(mSelected)) {
+            return true;
+        }
+
         mOptions[mSelected].callback();
         return false;
     }
@@ -90,3 +95,8 @@ bool MessageBox::Update(const VPADStatus& input)
 
     return true;
 }
+
+bool MessageBox::IsOptionEnabled(size_t index) const
+{
+    return true;
+}
@@ -40,6 +40,8 @@ public:
     virtual bool Update(const VPADStatus& input);
 
 protected:
+    virtual bool IsOptionEnabled(size_t index) const;
+
     std::string mTitle;
     std::string mMessage;
     std::vector<Option> mOptions;
@@ -0,0 +1,157 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "PaletteQuantizer.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <limits>
+
+namespace
+{
+
+std::uint32_t Distance(const std::array<std::uint8_t, 3>& a, std::uint8_t r, std::uint8_t g, std::uint8_t b)
+{
+    const std::int32_t dr = std::int32_t(a[0]) - r;
+    const std::int32_t dg = std::int32_t(a[1]) - g;
+    const std::int32_t db = std::int32_t(a[2]) - b;
+    return dr * dr + dg * dg + db * db;
+}
+
+// Distance between a value and the closest/furthest point of the range [min, max]
+std::uint32_t MinAxisDistance(std::int32_t value, std::int32_t min, std::int32_t max)
+{
+    std::int32_t d = 0;
+    if (value < min) {
+        d = min - value;
+    } else if (value > max) {
+        d = value - max;
+    }
+
+    return d * d;
+}
+
+std::uint32_t MaxAxisDistance(std::int32_t value, std::int32_t min, std::int32_t max)
+{
+    std::int32_t d = std::max(std::abs(value - min), std::abs(value - max));
+    return d * d;
+}
+
+}
+
+PaletteQuantizer::PaletteQuantizer(std::span<const std::uint32_t, 256> palette)
+ : mCells(CELLS * CELLS * CELLS, Cell{0, 0, false})
+{
+    for (std::size_t i = 0; i < palette.size(); i++) {
+        auto bytes = std::bit_cast<std::array<std::uint8_t, 4>>(palette[i]);
+        mColors[i] = { bytes[0], bytes[1], bytes[2] };
+    }
+}
+
+PaletteQuantizer::~PaletteQuantizer()
+{
+}
+
+const PaletteQuantizer::Cell& PaletteQuantizer::GetCell(std::uint32_t index)
+{
+    Cell& cell = mCells[index];
+    if (cell.valid) {
+        return cell;
+    }
+
+    constexpr std::int32_t CELL_SIZE = 256 / CELLS;
+    const std::int32_t minR = ((index >> (CELL_BITS * 2)) & (CELLS - 1)) * CELL_SIZE;
+    const std::int32_t minG = ((index >> CELL_BITS) & (CELLS - 1)) * CELL_SIZE;
+    const std::int32_t minB = (index & (CELLS - 1)) * CELL_SIZE;
+
+    // Find the smallest distance any palette entry is guaranteed to have to every color in the cell
+    std::array<std::uint32_t, 256> minDistances;
+    std::uint32_t bound = std::numeric_limits<std::uint32_t>::max();
+    for (std::size_t i = 0; i < mColors.size(); i++) {
+        if (i == TRANSPARENT_INDEX) {
+            continue;
+        }
+
+        const auto& color = mColors[i];
+        minDistances[i] = MinAxisDistance(color[0], minR, minR + CELL_SIZE - 1) +
+                          MinAxisDistance(color[1], minG, minG + CELL_SIZE - 1) +
+                          MinAxisDistance(color[2], minB, minB + CELL_SIZE - 1);
+        bound = std::min(bound, MaxAxisDistance(color[0], minR, minR + CELL_SIZE - 1) +
+                                MaxAxisDistance(color[1], minG, minG + CELL_SIZE - 1) +
+                                MaxAxisDistance(color[2], minB, minB + CELL_SIZE - 1));
+    }
+
+    // Only entries which can get closer than that bound are candidates
+    cell.first = mCandidates.size();
+    for (std::size_t i = 0; i < mColors.size(); i++) {
+        if (i != TRANSPARENT_INDEX && minDistances[i] <= bound) {
+            mCandidates.push_back(i);
+        }
+    }
+    cell.count = mCandidates.size() - cell.first;
+    cell.valid = true;
+
+    return cell;
+}
+
+std::uint8_t PaletteQuantizer::Map(std::uint8_t r, std::uint8_t g, std::uint8_t b)
+{
+    const std::uint32_t shift = 8 - CELL_BITS;
+    const Cell& cell = GetCell(((r >> shift) << (CELL_BITS * 2)) | ((g >> shift) << CELL_BITS) | (b >> shift));
+
+    std::uint8_t nearest = 0;
+    std::uint32_t nearestDistance = std::numeric_limits<std::uint32_t>::max();
+    for (std::uint32_t i = cell.first; i < cell.first + cell.count; i++) {
+        const std::uint8_t candidate = mCandidates[i];
+        const std::uint32_t distance = Distance(mColors[candidate], r, g, b);
+        if (distance < nearestDistance) {
+            nearest = candidate;
+            nearestDistance = distance;
+        }
+    }
+
+    return nearest;
+}
+
+bool PaletteQuantizer::Quantize(std::span<const std::uint8_t> rgba, std::span<std::uint8_t> out)
+{
+    if (rgba.size() != out.size() * 4) {
+        return false;
+    }
+
+    // Images usually have long runs of the same color, so remember the last one
+    std::uint32_t lastColor = 0;
+    std::uint8_t lastIndex = TRANSPARENT_INDEX;
+    bool hasLast = false;
+    for (std::size_t i = 0; i < out.size(); i++) {
+        const std::uint8_t* pixel = rgba.data() + i * 4;
+        if (pixel[3] < 0x80) {
+            out[i] = TRANSPARENT_INDEX;
+            continue;
+        }
+
+        const std::uint32_t color = (pixel[0] << 16) | (pixel[1] << 8) | pixel[2];
+        if (!hasLast || color != lastColor) {
+            lastColor = color;
+            lastIndex = Map(pixel[0], pixel[1], pixel[2]);
+            hasLast = true;
+        }
+
+        out[i] = lastIndex;
+    }
+
+    return true;
+}
@@ -0,0 +1,58 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "Firmware.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Maps RGBA colors onto the nearest entry of a 256 color bitmap palette.
+// Palette entries are expected to be stored as R, G, B, A bytes.
+class PaletteQuantizer {
+public:
+    // Index used for transparent pixels, it is never chosen as the nearest color
+    // since BitmapResource::BlendBitmap skips over these
+    static constexpr std::uint8_t TRANSPARENT_INDEX = BitmapResource::TRANSPARENT_INDEX;
+
+    PaletteQuantizer(std::span<const std::uint32_t, 256> palette);
+    virtual ~PaletteQuantizer();
+
+    std::uint8_t Map(std::uint8_t r, std::uint8_t g, std::uint8_t b);
+
+    // Quantize RGBA pixels (4 bytes per pixel), pixels with an alpha below 128 become TRANSPARENT_INDEX
+    bool Quantize(std::span<const std::uint8_t> rgba, std::span<std::uint8_t> out);
+
+private:
+    // The color space is divided into CELLS^3 cells, each cell lazily gets a list of
+    // palette entries which can be the nearest color for any color inside of the cell
+    static constexpr std::uint32_t CELL_BITS = 5;
+    static constexpr std::uint32_t CELLS = 1u << CELL_BITS;
+
+    struct Cell {
+        std::uint32_t first;
+        std::uint16_t count;
+        bool valid;
+    };
+
+    const Cell& GetCell(std::uint32_t index);
+
+    std::array<std::array<std::uint8_t, 3>, 256> mColors;
+    std::vector<Cell> mCells;
+    std::vector<std::uint8_t> mCandidates;
+};
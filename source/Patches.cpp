@@ -0,0 +1,120 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Patches.hpp"
+#include "Utils.hpp"
+
+#include <logo_overlay.h>
+
+namespace
+{
+
+// Expects a firmware which passed Patches::CheckBuiltin
+void PatchBuiltin(FirmwareBlob& blob)
+{
+    // Patch the LVC section
+    if (auto lvc = blob.GetFirmware().GetSection<GenericSection>("LVC_")) {
+        // Patch jumptable to make ID 1 valid
+        lvc->WriteAt<std::uint8_t> (0x0003c9c4, 0x30);
+        // Patch config table at offset 1 to insert region
+        lvc->WriteAt<std::uint32_t>(0x000b28d0, 0x3);   // size
+        lvc->WriteAt<std::uint32_t>(0x000b28d4, 0x103); // eeprom offset
+
+        // Patch jumptable to make ID 4 valid
+        lvc->WriteAt<std::uint8_t> (0x0003c9c7, 0x30);
+        // Patch config table at offset 4 to insert board config
+        lvc->WriteAt<std::uint32_t>(0x000b28e8, 0x3);   // size
+        lvc->WriteAt<std::uint32_t>(0x000b28ec, 0x106); // eeprom offset
+    }
+
+    // Add "Modified Firmware" logo to startup screen in resource section
+    if (auto img = blob.GetFirmware().GetSection<ResourceSection>("IMG_")) {
+        if (auto startupScreen = img->GetResource<BitmapResource>(Patches::STARTUP_SCREEN_ID)) {
+            startupScreen->BlendOverlay(logo_overlay);
+        }
+    }
+
+    // Patch version in version section
+    if (auto ver = blob.GetFirmware().GetSection<GenericSection>("VER_")) {
+        ver->WriteAt<std::uint32_t>(0, Patches::BUILTIN_PATCHED_VERSION);
+    }
+
+    blob.SetImageVersion(Patches::BUILTIN_PATCHED_VERSION);
+}
+
+}
+
+namespace Patches
+{
+
+std::expected<void, std::string> CheckBuiltin(FirmwareBlob& blob)
+{
+    if (blob.GetImageVersion() != BUILTIN_SOURCE_VERSION) {
+        return std::unexpected("Invalid image version to patch");
+    }
+
+    auto lvc = blob.GetFirmware().GetSection<GenericSection>("LVC_");
+    if (!lvc) {
+        return std::unexpected("LVC section not found in firmware");
+    }
+
+    if (lvc->GetCRC() != 0x82d87264) {
+        return std::unexpected("Invalid LVC checksum");
+    }
+
+    auto img = blob.GetFirmware().GetSection<ResourceSection>("IMG_");
+    if (!img) {
+        return std::unexpected("IMG section not found");
+    }
+
+    if (!img->GetResource<BitmapResource>(STARTUP_SCREEN_ID)) {
+        return std::unexpected("Startup screen not found");
+    }
+
+    if (!blob.GetFirmware().GetSection<GenericSection>("VER_")) {
+        return std::unexpected("Version section not found");
+    }
+
+    return {};
+}
+
+std::expected<void, std::string> ApplyBuiltin(FirmwareBlob& blob)
+{
+    auto checked = CheckBuiltin(blob);
+    if (!checked) {
+        return checked;
+    }
+
+    PatchBuiltin(blob);
+    return {};
+}
+
+#ifndef __WIIU__
+// Only declared in tools/drxfw/PatchesTesting.hpp and not built for the console, DRXUtil always goes through ApplyBuiltin
+void ApplyBuiltinUnchecked(FirmwareBlob& blob)
+{
+    PatchBuiltin(blob);
+}
+#endif
+
+bool IsKnownPatchedCRC(std::uint32_t crc)
+{
+    return crc == 0xd13694f3 || // JPN
+           crc == 0xb0aed5b6 || // USA
+           crc == 0x2d177dfb;   // EUR
+}
+
+}
@@ -0,0 +1,44 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "Firmware.hpp"
+#include <cstdint>
+#include <expected>
+#include <string>
+
+// Built-in firmware patches, shared between DRXUtil and the host tools
+namespace Patches
+{
+
+// Image version of the firmware the built-in patches apply to
+constexpr std::uint32_t BUILTIN_SOURCE_VERSION = 0x190c0117;
+// Image version of the patched firmware
+constexpr std::uint32_t BUILTIN_PATCHED_VERSION = 0xfe000000;
+// Resource ID of the startup screen bitmap in the IMG_ section
+constexpr std::uint16_t STARTUP_SCREEN_ID = 0x2001;
+
+// Check that blob is the firmware the built-in patches were made for
+std::expected<void, std::string> CheckBuiltin(FirmwareBlob& blob);
+
+// Check and apply the built-in patches to blob
+std::expected<void, std::string> ApplyBuiltin(FirmwareBlob& blob);
+
+// Check if the CRC of a whole image with the built-in patches applied is one of the known ones
+bool IsKnownPatchedCRC(std::uint32_t crc);
+
+}
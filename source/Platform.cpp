@@ -0,0 +1,37 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Platform.hpp"
+
+#ifdef __WIIU__
+#include "PlatformWiiU.hpp"
+#else
+#include "PlatformSimulator.hpp"
+#endif
+
+Platform::~Platform()
+{
+}
+
+Platform& Platform::GetDefault()
+{
+#ifdef __WIIU__
+    static WiiUPlatform platform;
+#else
+    static SimulatedPlatform platform;
+#endif
+    return platform;
+}
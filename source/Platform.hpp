@@ -0,0 +1,108 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+
+// System services used by the screens.
+// On the Wii U these are CCR, MCP and Mocha calls, elsewhere a simulated DRC is used,
+// so the flash and EEPROM flows can run on a PC (see SimulatedPlatform).
+// Unless stated otherwise all DRC calls target the first DRC.
+class Platform {
+public:
+    enum class Destination {
+        DRH,
+        DRC0,
+    };
+
+    enum class DRCState {
+        ACTIVE,
+        FWUPDATE,
+        STANDALONE,
+        // Any state the application doesn't use
+        OTHER,
+    };
+
+    enum class ExtId {
+        LANGUAGE,
+        RC_DATABASE,
+        UNK2,
+        UNK3,
+        UNK4,
+    };
+
+    struct SoftwareVersion {
+        std::uint32_t runningVersion;
+        std::uint32_t activeVersion;
+    };
+
+    // Called with the IOS error of the update once it finished, possibly from another thread
+    using UpdateCallback = std::function<void(std::int32_t result)>;
+
+public:
+    virtual ~Platform();
+
+    // The platform the application is running on, created on first use
+    static Platform& GetDefault();
+
+    virtual bool InitCCR() = 0;
+    virtual void ExitCCR() = 0;
+    virtual bool InitMocha() = 0;
+    virtual void DeInitMocha() = 0;
+    // Mount the MLC to /vol/storage_mlc01, which is needed to read and write the DRC firmware
+    virtual bool MountMLC() = 0;
+    virtual void UnmountMLC() = 0;
+    // Disable the IOSU version check, so images with any version can be flashed
+    virtual bool PatchIOS() = 0;
+
+    virtual std::uint64_t GetTimeMs() = 0;
+    virtual void SleepMs(std::uint32_t milliseconds) = 0;
+
+    // Path of the installed DRC firmware title
+    virtual bool GetDRCFirmwareTitlePath(std::string& path) = 0;
+
+    virtual bool GetSoftwareVersion(Destination destination, SoftwareVersion& version) = 0;
+    virtual bool GetExtId(ExtId ext, std::uint32_t& id) = 0;
+    virtual bool SetCaffeineSlot(std::uint8_t slot) = 0;
+
+    // The system's cached copy of the DRC EEPROM, reads fail until the EEPROM was read after a reattach
+    virtual bool ReadEeprom(std::uint32_t offset, std::span<std::uint8_t> data) = 0;
+    virtual bool WriteEeprom(std::uint32_t offset, std::span<const std::uint8_t> data) = 0;
+    // Write a UIC config value on the DRC, configs 1 and 4 are only available with the patched firmware
+    virtual bool SetUicConfig(std::uint8_t configId, std::span<const std::uint8_t> data) = 0;
+    // Checksum of EEPROM values, as calculated by the DRC
+    virtual std::uint16_t CalcCRC16(std::span<const std::uint8_t> data) = 0;
+
+    virtual bool GetDRCState(DRCState& state) = 0;
+    // Start a reattach, the state is requested with SetDRCState and WaitReattach blocks until the DRC is back
+    virtual void InitReattach() = 0;
+    virtual bool SetDRCState(DRCState state) = 0;
+    virtual bool WaitReattach() = 0;
+
+    // Flash the image at path, which needs to be accessible by IOS
+    virtual bool StartUpdate(const std::string& path, UpdateCallback callback) = 0;
+    virtual bool AbortUpdate() = 0;
+    virtual bool ActivateUpdate() = 0;
+    // Progress of a running update in percent
+    virtual bool GetUpdateProgress(std::int32_t& progress) = 0;
+    // Block until the update finished and its callback was called, or timeoutMs passed.
+    // Returns false on timeout, true as soon as the update finished or if no update is running.
+    virtual bool WaitUpdate(std::uint32_t timeoutMs) = 0;
+};
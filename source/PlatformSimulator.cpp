@@ -0,0 +1,426 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "PlatformSimulator.hpp"
+#include "Firmware.hpp"
+#include "stream.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+
+// EEPROM offsets of the values written by the UIC configs, every value is followed by its CRC16
+constexpr std::uint32_t BOARD_INFO_OFFSET = 0x100;
+constexpr std::uint32_t REGION_OFFSET = 0x103;
+constexpr std::uint32_t DEVICE_INFO_OFFSET = 0x106;
+
+constexpr std::uint8_t REGION_CONFIG_ID = 1;
+constexpr std::uint8_t DEVICE_INFO_CONFIG_ID = 4;
+
+}
+
+SimulatedPlatform::SimulatedPlatform()
+ : SimulatedPlatform(Config())
+{
+}
+
+SimulatedPlatform::SimulatedPlatform(const Config& config)
+ : mConfig(config),
+   mTime(0),
+   mStats(),
+   mEeprom(),
+   mCachedEeprom(),
+   mEepromReadyTime(0),
+   mRunningVersion(config.drcVersion),
+   mActiveVersion(config.drcVersion),
+   mAttached(true),
+   mReattachInitialized(false),
+   mState(DRCState::ACTIVE),
+   mPendingState(DRCState::ACTIVE),
+   mReattachTime(0),
+   mUpdateStatus(UpdateStatus::NONE),
+   mUpdateVersion(0),
+   mUpdateStart(0),
+   mUpdateCallback()
+{
+    WriteValue(mEeprom, BOARD_INFO_OFFSET, config.boardInfo);
+    WriteValue(mEeprom, REGION_OFFSET, config.region);
+    WriteValue(mEeprom, DEVICE_INFO_OFFSET, config.deviceInfo);
+    mCachedEeprom = mEeprom;
+}
+
+SimulatedPlatform::~SimulatedPlatform()
+{
+}
+
+bool SimulatedPlatform::InitCCR()
+{
+    auto lock = BeginRequest(&Stats::systemRequests);
+    return true;
+}
+
+void SimulatedPlatform::ExitCCR()
+{
+    auto lock = BeginRequest(&Stats::systemRequests);
+}
+
+bool SimulatedPlatform::InitMocha()
+{
+    auto lock = BeginRequest(&Stats::systemRequests);
+    return true;
+}
+
+void SimulatedPlatform::DeInitMocha()
+{
+    auto lock = BeginRequest(&Stats::systemRequests);
+}
+
+bool SimulatedPlatform::MountMLC()
+{
+    auto lock = BeginRequest(&Stats::systemRequests);
+    return true;
+}
+
+void SimulatedPlatform::UnmountMLC()
+{
+    auto lock = BeginRequest(&Stats::systemRequests);
+}
+
+bool SimulatedPlatform::PatchIOS()
+{
+    auto lock = BeginRequest(&Stats::systemRequests);
+    return true;
+}
+
+std::uint64_t SimulatedPlatform::GetTimeMs()
+{
+    std::lock_guard lock(mMutex);
+    return mTime;
+}
+
+void SimulatedPlatform::SleepMs(std::uint32_t milliseconds)
+{
+    std::unique_lock lock(mMutex);
+    Advance(lock, milliseconds);
+}
+
+bool SimulatedPlatform::GetDRCFirmwareTitlePath(std::string& path)
+{
+    auto lock = BeginRequest(&Stats::systemRequests);
+    path = mConfig.firmwareTitlePath;
+    return true;
+}
+
+bool SimulatedPlatform::GetSoftwareVersion(Destination destination, SoftwareVersion& version)
+{
+    auto lock = BeginRequest(&Stats::drcRequests);
+    if (destination == Destination::DRH) {
+        version.runningVersion = mConfig.drhVersion;
+        version.activeVersion = mConfig.drhVersion;
+        return true;
+    }
+
+    if (!mAttached) {
+        return false;
+    }
+
+    version.runningVersion = mRunningVersion;
+    version.activeVersion = mActiveVersion;
+    return true;
+}
+
+bool SimulatedPlatform::GetExtId(ExtId ext, std::uint32_t& id)
+{
+    auto lock = BeginRequest(&Stats::drcRequests);
+    if (!mAttached) {
+        return false;
+    }
+
+    id = 0x01000000 | static_cast<std::uint32_t>(ext);
+    return true;
+}
+
+bool SimulatedPlatform::SetCaffeineSlot(std::uint8_t slot)
+{
+    auto lock = BeginRequest(&Stats::drcRequests);
+    return mAttached;
+}
+
+bool SimulatedPlatform::ReadEeprom(std::uint32_t offset, std::span<std::uint8_t> data)
+{
+    auto lock = BeginRequest(&Stats::eepromRequests);
+    if (!mAttached || mTime < mEepromReadyTime || offset + data.size() > mCachedEeprom.size()) {
+        return false;
+    }
+
+    std::copy_n(mCachedEeprom.begin() + offset, data.size(), data.begin());
+    return true;
+}
+
+bool SimulatedPlatform::WriteEeprom(std::uint32_t offset, std::span<const std::uint8_t> data)
+{
+    auto lock = BeginRequest(&Stats::eepromRequests);
+    if (offset + data.size() > mCachedEeprom.size()) {
+        return false;
+    }
+
+    std::copy(data.begin(), data.end(), mCachedEeprom.begin() + offset);
+    return true;
+}
+
+bool SimulatedPlatform::SetUicConfig(std::uint8_t configId, std::span<const std::uint8_t> data)
+{
+    auto lock = BeginRequest(&Stats::drcRequests);
+    if (!mAttached || mState != DRCState::ACTIVE || mRunningVersion != mConfig.patchedVersion) {
+        return false;
+    }
+
+    std::uint32_t offset;
+    if (configId == REGION_CONFIG_ID) {
+        offset = REGION_OFFSET;
+    } else if (configId == DEVICE_INFO_CONFIG_ID) {
+        offset = DEVICE_INFO_OFFSET;
+    } else {
+        return false;
+    }
+
+    // The value followed by its CRC16
+    if (data.size() != 3) {
+        return false;
+    }
+
+    std::copy(data.begin(), data.end(), mEeprom.begin() + offset);
+    return true;
+}
+
+std::uint16_t SimulatedPlatform::CalcCRC16(std::span<const std::uint8_t> data)
+{
+    // CRC-16/CCITT, the simulator only needs to agree with itself
+    std::uint16_t crc = 0xffff;
+    for (std::uint8_t byte : data) {
+        crc ^= std::uint16_t(byte) << 8;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+
+    return crc;
+}
+
+bool SimulatedPlatform::GetDRCState(DRCState& state)
+{
+    auto lock = BeginRequest(&Stats::drcRequests);
+    if (!mAttached) {
+        return false;
+    }
+
+    state = mState;
+    return true;
+}
+
+void SimulatedPlatform::InitReattach()
+{
+    auto lock = BeginRequest(&Stats::drcRequests);
+    mReattachInitialized = true;
+}
+
+bool SimulatedPlatform::SetDRCState(DRCState state)
+{
+    auto lock = BeginRequest(&Stats::drcRequests);
+    if (!mAttached || state == DRCState::OTHER) {
+        return false;
+    }
+
+    // Leaving update mode cancels a running update
+    if (mState == DRCState::FWUPDATE && state != DRCState::FWUPDATE) {
+        mUpdateStatus = UpdateStatus::NONE;
+        mUpdateCallback = nullptr;
+    }
+
+    Detach(state, mConfig.reattachMs);
+    return true;
+}
+
+bool SimulatedPlatform::WaitReattach()
+{
+    auto lock = BeginRequest(&Stats::drcRequests);
+    if (!mReattachInitialized) {
+        return false;
+    }
+
+    mReattachInitialized = false;
+    if (!mAttached) {
+        Advance(lock, mReattachTime - mTime);
+    }
+
+    return !mConfig.failReattach;
+}
+
+bool SimulatedPlatform::StartUpdate(const std::string& path, UpdateCallback callback)
+{
+    auto lock = BeginRequest(&Stats::drcRequests);
+    if (!mAttached || mState != DRCState::FWUPDATE || mUpdateStatus == UpdateStatus::RUNNING) {
+        return false;
+    }
+
+    // Only the header is checked, the DRC would reject a corrupted image while flashing
+    FileStream stream(path);
+    auto info = FirmwareBlob::Peek(stream);
+    if (!info || !info->headerCRCValid || !info->superCRCsValid || info->type != Firmware::Type::DRC) {
+        return false;
+    }
+
+    mUpdateStatus = UpdateStatus::RUNNING;
+    mUpdateVersion = info->imageVersion;
+    mUpdateStart = mTime;
+    mUpdateCallback = std::move(callback);
+    return true;
+}
+
+bool SimulatedPlatform::AbortUpdate()
+{
+    auto lock = BeginRequest(&Stats::drcRequests);
+    if (mUpdateStatus != UpdateStatus::RUNNING && mTime < mUpdateStart + mConfig.updateMs + mConfig.abortDelayMs) {
+        return false;
+    }
+
+    mUpdateStatus = UpdateStatus::NONE;
+    mUpdateCallback = nullptr;
+    return true;
+}
+
+bool SimulatedPlatform::ActivateUpdate()
+{
+    auto lock = BeginRequest(&Stats::drcRequests);
+    if (!mAttached || mUpdateStatus != UpdateStatus::DONE || mConfig.failActivate) {
+        return false;
+    }
+
+    // The DRC reboots into the new firmware
+    mUpdateStatus = UpdateStatus::NONE;
+    mRunningVersion = mUpdateVersion;
+    mActiveVersion = mUpdateVersion;
+    Detach(DRCState::FWUPDATE, mConfig.reattachMs * 2);
+    return true;
+}
+
+bool SimulatedPlatform::GetUpdateProgress(std::int32_t& progress)
+{
+    auto lock = BeginRequest(&Stats::drcRequests);
+    if (!mAttached || mState != DRCState::FWUPDATE) {
+        return false;
+    }
+
+    switch (mUpdateStatus) {
+    case UpdateStatus::RUNNING:
+        progress = (mTime - mUpdateStart) * 100 / std::max<std::uint32_t>(mConfig.updateMs, 1);
+        break;
+    case UpdateStatus::DONE:
+        progress = 100;
+        break;
+    default:
+        progress = 0;
+        break;
+    }
+
+    return true;
+}
+
+bool SimulatedPlatform::WaitUpdate(std::uint32_t timeoutMs)
+{
+    std::unique_lock lock(mMutex);
+    if (mUpdateStatus != UpdateStatus::RUNNING) {
+        return true;
+    }
+
+    // Wake up exactly when the update finishes, like the callback would on the console
+    const std::uint64_t remaining = mUpdateStart + mConfig.updateMs - mTime;
+    Advance(lock, std::min<std::uint64_t>(timeoutMs, remaining));
+    return mUpdateStatus != UpdateStatus::RUNNING;
+}
+
+SimulatedPlatform::Stats SimulatedPlatform::GetStats()
+{
+    std::lock_guard lock(mMutex);
+    return mStats;
+}
+
+std::array<std::uint8_t, 0x400> SimulatedPlatform::GetEeprom()
+{
+    std::lock_guard lock(mMutex);
+    return mEeprom;
+}
+
+std::uint32_t SimulatedPlatform::GetActiveVersion()
+{
+    std::lock_guard lock(mMutex);
+    return mActiveVersion;
+}
+
+std::unique_lock<std::mutex> SimulatedPlatform::BeginRequest(std::uint32_t Stats::* counter)
+{
+    std::unique_lock lock(mMutex);
+    mStats.*counter += 1;
+    Advance(lock, mConfig.requestLatencyMs);
+    return lock;
+}
+
+void SimulatedPlatform::Advance(std::unique_lock<std::mutex>& lock, std::uint64_t milliseconds)
+{
+    mTime += milliseconds;
+
+    if (!mAttached && mTime >= mReattachTime) {
+        Attach();
+    }
+
+    if (mUpdateStatus == UpdateStatus::RUNNING && mTime >= mUpdateStart + mConfig.updateMs) {
+        mUpdateStatus = mConfig.failUpdate ? UpdateStatus::FAILED : UpdateStatus::DONE;
+
+        UpdateCallback callback = std::exchange(mUpdateCallback, nullptr);
+        if (callback) {
+            lock.unlock();
+            // IOS_ERROR_OK or an IOS error
+            callback(mConfig.failUpdate ? -1 : 0);
+            lock.lock();
+        }
+    }
+}
+
+void SimulatedPlatform::Detach(DRCState state, std::uint64_t delay)
+{
+    mAttached = false;
+    mPendingState = state;
+    mReattachTime = mTime + delay;
+}
+
+void SimulatedPlatform::Attach()
+{
+    mAttached = true;
+    mState = mPendingState;
+
+    // The system reads the EEPROM again after every reattach
+    mCachedEeprom = mEeprom;
+    mEepromReadyTime = mReattachTime + mConfig.eepromDelayMs;
+}
+
+void SimulatedPlatform::WriteValue(std::span<std::uint8_t> eeprom, std::uint32_t offset, std::uint8_t value)
+{
+    const std::uint16_t crc = CalcCRC16(std::span(&value, 1));
+    eeprom[offset] = value;
+    eeprom[offset + 1] = crc & 0xff;
+    eeprom[offset + 2] = crc >> 8;
+}
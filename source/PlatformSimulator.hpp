@@ -0,0 +1,145 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "Platform.hpp"
+#include "Patches.hpp"
+#include <array>
+#include <mutex>
+
+// Simulated DRC for running the flash and EEPROM flows on a PC.
+// Time is simulated as well: it only advances with SleepMs and the configured latencies,
+// so flows run instantly and the same configuration always results in the same timings.
+class SimulatedPlatform : public Platform {
+public:
+    struct Config {
+        // Duration of every request to the DRC
+        std::uint32_t requestLatencyMs = 2;
+        // Time until the DRC is back after a state change, rebooting after an activation takes twice as long
+        std::uint32_t reattachMs = 2500;
+        // Time after a reattach until the cached EEPROM was read from the DRC
+        std::uint32_t eepromDelayMs = 400;
+        // Time to flash an image
+        std::uint32_t updateMs = 45000;
+        // Time after an update finished until it can be aborted
+        std::uint32_t abortDelayMs = 300;
+
+        bool failReattach = false;
+        bool failUpdate = false;
+        bool failActivate = false;
+
+        std::uint32_t drcVersion = Patches::BUILTIN_SOURCE_VERSION;
+        std::uint32_t drhVersion = 0x000e0000;
+        // UIC configs 1 and 4 are only accepted while this version is running
+        std::uint32_t patchedVersion = Patches::BUILTIN_PATCHED_VERSION;
+        std::string firmwareTitlePath = "sim";
+
+        std::uint8_t boardInfo = 0x8b;
+        std::uint8_t region = 0x01;
+        std::uint8_t deviceInfo = 0x05;
+    };
+
+    // Amount of requests, per kind of request
+    struct Stats {
+        std::uint32_t systemRequests;
+        std::uint32_t drcRequests;
+        std::uint32_t eepromRequests;
+    };
+
+public:
+    SimulatedPlatform();
+    SimulatedPlatform(const Config& config);
+    virtual ~SimulatedPlatform();
+
+    bool InitCCR() override;
+    void ExitCCR() override;
+    bool InitMocha() override;
+    void DeInitMocha() override;
+    bool MountMLC() override;
+    void UnmountMLC() override;
+    bool PatchIOS() override;
+
+    std::uint64_t GetTimeMs() override;
+    void SleepMs(std::uint32_t milliseconds) override;
+
+    bool GetDRCFirmwareTitlePath(std::string& path) override;
+
+    bool GetSoftwareVersion(Destination destination, SoftwareVersion& version) override;
+    bool GetExtId(ExtId ext, std::uint32_t& id) override;
+    bool SetCaffeineSlot(std::uint8_t slot) override;
+
+    bool ReadEeprom(std::uint32_t offset, std::span<std::uint8_t> data) override;
+    bool WriteEeprom(std::uint32_t offset, std::span<const std::uint8_t> data) override;
+    bool SetUicConfig(std::uint8_t configId, std::span<const std::uint8_t> data) override;
+    std::uint16_t CalcCRC16(std::span<const std::uint8_t> data) override;
+
+    bool GetDRCState(DRCState& state) override;
+    void InitReattach() override;
+    bool SetDRCState(DRCState state) override;
+    bool WaitReattach() override;
+
+    bool StartUpdate(const std::string& path, UpdateCallback callback) override;
+    bool AbortUpdate() override;
+    bool ActivateUpdate() override;
+    bool GetUpdateProgress(std::int32_t& progress) override;
+    bool WaitUpdate(std::uint32_t timeoutMs) override;
+
+    Stats GetStats();
+    // The EEPROM of the DRC itself, the cached copy is only updated on reattach and by WriteEeprom
+    std::array<std::uint8_t, 0x400> GetEeprom();
+    std::uint32_t GetActiveVersion();
+
+private:
+    enum class UpdateStatus {
+        NONE,
+        RUNNING,
+        DONE,
+        FAILED,
+    };
+
+    // Lock, count the request and let the request latency pass
+    std::unique_lock<std::mutex> BeginRequest(std::uint32_t Stats::* counter);
+    // Advance the simulated time, this may complete a running update and call its callback without the lock held
+    void Advance(std::unique_lock<std::mutex>& lock, std::uint64_t milliseconds);
+    // Detach the DRC, it comes back in the specified state after delay
+    void Detach(DRCState state, std::uint64_t delay);
+    void Attach();
+    void WriteValue(std::span<std::uint8_t> eeprom, std::uint32_t offset, std::uint8_t value);
+
+    Config mConfig;
+    std::mutex mMutex;
+    std::uint64_t mTime;
+    Stats mStats;
+
+    std::array<std::uint8_t, 0x400> mEeprom;
+    std::array<std::uint8_t, 0x400> mCachedEeprom;
+    std::uint64_t mEepromReadyTime;
+
+    std::uint32_t mRunningVersion;
+    std::uint32_t mActiveVersion;
+
+    bool mAttached;
+    bool mReattachInitialized;
+    DRCState mState;
+    DRCState mPendingState;
+    std::uint64_t mReattachTime;
+
+    UpdateStatus mUpdateStatus;
+    std::uint32_t mUpdateVersion;
+    std::uint64_t mUpdateStart;
+    UpdateCallback mUpdateCallback;
+};
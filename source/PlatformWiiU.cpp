@@ -0,0 +1,335 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "PlatformWiiU.hpp"
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include <coreinit/mcp.h>
+#include <coreinit/thread.h>
+#include <coreinit/time.h>
+#include <mocha/mocha.h>
+#include <nsysccr/cdc.h>
+#include <nsysccr/cfg.h>
+#include <nn/ccr.h>
+
+namespace
+{
+
+// The IOSU version check in the update code, see PatchIOS
+constexpr std::uint32_t kVersionCheckAddress = 0x11f53cf4;
+constexpr std::uint32_t kVersionCheckOp = 0xeb00bd82;
+// mov r0, #1
+constexpr std::uint32_t kVersionCheckPatchedOp = 0xe3a00001;
+
+// Slot of CCR_CDC_DESTINATION_DRC0, used by the CCRSys and CCRCFG functions
+constexpr std::uint32_t kDRCSlot = CCR_CDC_DESTINATION_DRC0 - CCR_CDC_DESTINATION_DRC0;
+
+CCRCDCDestination ToCDCDestination(Platform::Destination destination)
+{
+    switch (destination) {
+    case Platform::Destination::DRH:
+        return CCR_CDC_DESTINATION_DRH;
+    case Platform::Destination::DRC0:
+        return CCR_CDC_DESTINATION_DRC0;
+    }
+
+    return CCR_CDC_DESTINATION_DRC0;
+}
+
+Platform::DRCState FromCDCState(uint8_t state)
+{
+    switch (state) {
+    case CCR_CDC_DRC_STATE_ACTIVE:
+        return Platform::DRCState::ACTIVE;
+    case CCR_CDC_DRC_STATE_FWUPDATE:
+        return Platform::DRCState::FWUPDATE;
+    case CCR_CDC_DRC_STATE_STANDALONE:
+        return Platform::DRCState::STANDALONE;
+    }
+
+    return Platform::DRCState::OTHER;
+}
+
+void SoftwareUpdateCallback(IOSError error, void* arg)
+{
+    static_cast<WiiUPlatform*>(arg)->OnUpdateCompleted(error);
+}
+
+}
+
+WiiUPlatform::WiiUPlatform()
+ : mUpdateRunning(false)
+{
+}
+
+WiiUPlatform::~WiiUPlatform()
+{
+}
+
+bool WiiUPlatform::InitCCR()
+{
+    CCRSysInit();
+    return true;
+}
+
+void WiiUPlatform::ExitCCR()
+{
+    CCRSysExit();
+}
+
+bool WiiUPlatform::InitMocha()
+{
+    return Mocha_InitLibrary() == MOCHA_RESULT_SUCCESS;
+}
+
+void WiiUPlatform::DeInitMocha()
+{
+    Mocha_DeInitLibrary();
+}
+
+bool WiiUPlatform::MountMLC()
+{
+    return Mocha_MountFS("storage_mlc01", nullptr, "/vol/storage_mlc01") == MOCHA_RESULT_SUCCESS;
+}
+
+void WiiUPlatform::UnmountMLC()
+{
+    Mocha_UnmountFS("storage_mlc01");
+}
+
+bool WiiUPlatform::PatchIOS()
+{
+    uint32_t op;
+    if (Mocha_IOSUKernelRead32(kVersionCheckAddress, &op) != MOCHA_RESULT_SUCCESS) {
+        return false;
+    }
+
+    if (op == kVersionCheckPatchedOp) {
+        // already patched
+        return true;
+    }
+
+    if (op != kVersionCheckOp) {
+        return false;
+    }
+
+    // nop IOSU version check
+    return Mocha_IOSUKernelWrite32(kVersionCheckAddress, kVersionCheckPatchedOp) == MOCHA_RESULT_SUCCESS;
+}
+
+std::uint64_t WiiUPlatform::GetTimeMs()
+{
+    return OSTicksToMilliseconds(OSGetSystemTime());
+}
+
+void WiiUPlatform::SleepMs(std::uint32_t milliseconds)
+{
+    OSSleepTicks(OSMillisecondsToTicks(milliseconds));
+}
+
+bool WiiUPlatform::GetDRCFirmwareTitlePath(std::string& path)
+{
+    int32_t handle = MCP_Open();
+    if (handle < 0) {
+        return false;
+    }
+
+    alignas(0x40) MCPTitleListType title;
+    uint32_t titleCount = 0;
+    MCPError error = MCP_TitleListByAppType(handle, MCP_APP_TYPE_DRC_FIRMWARE, &titleCount, &title, sizeof(title));
+    MCP_Close(handle);
+
+    if (error != 0 || titleCount != 1) {
+        return false;
+    }
+
+    path = &title.path[0];
+    return true;
+}
+
+bool WiiUPlatform::GetSoftwareVersion(Destination destination, SoftwareVersion& version)
+{
+    CCRCDCSoftwareVersion softwareVersion;
+    if (CCRCDCSoftwareGetVersion(ToCDCDestination(destination), &softwareVersion) != 0) {
+        return false;
+    }
+
+    version.runningVersion = softwareVersion.runningVersion;
+    version.activeVersion = softwareVersion.activeVersion;
+    return true;
+}
+
+bool WiiUPlatform::GetExtId(ExtId ext, std::uint32_t& id)
+{
+    // The ext ids are in the same order as CCRCDCExt
+    uint32_t extId;
+    if (CCRCDCSoftwareGetExtId(CCR_CDC_DESTINATION_DRC0, static_cast<CCRCDCExt>(CCR_CDC_EXT_LANGUAGE + static_cast<int>(ext)), &extId) != 0) {
+        return false;
+    }
+
+    id = extId;
+    return true;
+}
+
+bool WiiUPlatform::SetCaffeineSlot(std::uint8_t slot)
+{
+    return CCRSysCaffeineSetCaffeineSlot(slot) == 0;
+}
+
+bool WiiUPlatform::ReadEeprom(std::uint32_t offset, std::span<std::uint8_t> data)
+{
+    return CCRCFGGetCachedEeprom(kDRCSlot, offset, data.data(), data.size()) == 0;
+}
+
+bool WiiUPlatform::WriteEeprom(std::uint32_t offset, std::span<const std::uint8_t> data)
+{
+    return CCRCFGSetCachedEeprom(kDRCSlot, offset, const_cast<std::uint8_t*>(data.data()), data.size()) == 0;
+}
+
+bool WiiUPlatform::SetUicConfig(std::uint8_t configId, std::span<const std::uint8_t> data)
+{
+    CCRCDCUicConfig cfg{};
+    if (data.size() > sizeof(cfg.data)) {
+        return false;
+    }
+
+    cfg.configId = configId;
+    cfg.size = data.size();
+    std::copy(data.begin(), data.end(), cfg.data);
+    return CCRCDCPerSetUicConfig(CCR_CDC_DESTINATION_DRC0, &cfg) == 0;
+}
+
+std::uint16_t WiiUPlatform::CalcCRC16(std::span<const std::uint8_t> data)
+{
+    return CCRCDCCalcCRC16(const_cast<std::uint8_t*>(data.data()), data.size());
+}
+
+bool WiiUPlatform::GetDRCState(DRCState& state)
+{
+    CCRCDCDrcState drcState;
+    if (CCRCDCSysGetDrcState(CCR_CDC_DESTINATION_DRC0, &drcState) != 0) {
+        return false;
+    }
+
+    state = FromCDCState(drcState.state);
+    return true;
+}
+
+void WiiUPlatform::InitReattach()
+{
+    __CCRSysInitReattach(kDRCSlot);
+}
+
+bool WiiUPlatform::SetDRCState(DRCState state)
+{
+    CCRCDCDrcStateEnum cdcState;
+    switch (state) {
+    case DRCState::ACTIVE:
+        cdcState = CCR_CDC_DRC_STATE_ACTIVE;
+        break;
+    case DRCState::FWUPDATE:
+        cdcState = CCR_CDC_DRC_STATE_FWUPDATE;
+        break;
+    case DRCState::STANDALONE:
+        cdcState = CCR_CDC_DRC_STATE_STANDALONE;
+        break;
+    case DRCState::OTHER:
+        return false;
+    }
+
+    // Only the state field changes, the other fields are read back right before setting it
+    std::lock_guard lock(mDRCStateMutex);
+    CCRCDCDrcState drcState;
+    if (CCRCDCSysGetDrcState(CCR_CDC_DESTINATION_DRC0, &drcState) != 0) {
+        return false;
+    }
+
+    drcState.state = cdcState;
+    return CCRCDCSysSetDrcState(CCR_CDC_DESTINATION_DRC0, &drcState) == 0;
+}
+
+bool WiiUPlatform::WaitReattach()
+{
+    return __CCRSysWaitReattach(kDRCSlot, FALSE) == 0;
+}
+
+bool WiiUPlatform::StartUpdate(const std::string& path, UpdateCallback callback)
+{
+    {
+        std::lock_guard lock(mUpdateMutex);
+        mUpdateCallback = std::move(callback);
+        mUpdateRunning = true;
+    }
+
+    if (CCRCDCSoftwareUpdate(CCR_CDC_DESTINATION_DRC0, path.c_str(), SoftwareUpdateCallback, this) != 0) {
+        // The callback won't be called, don't keep it around
+        std::lock_guard lock(mUpdateMutex);
+        mUpdateCallback = nullptr;
+        mUpdateRunning = false;
+        return false;
+    }
+
+    return true;
+}
+
+bool WiiUPlatform::AbortUpdate()
+{
+    return CCRCDCSoftwareAbort(CCR_CDC_DESTINATION_DRC0) == 0;
+}
+
+bool WiiUPlatform::ActivateUpdate()
+{
+    return CCRCDCSoftwareActivate(CCR_CDC_DESTINATION_DRC0) == 0;
+}
+
+bool WiiUPlatform::GetUpdateProgress(std::int32_t& progress)
+{
+    CCRCDCFWInfo fwInfo{};
+    if (CCRCDCGetFWInfo(CCR_CDC_DESTINATION_DRC0, &fwInfo) != 0) {
+        return false;
+    }
+
+    progress = fwInfo.updateProgress;
+    return true;
+}
+
+bool WiiUPlatform::WaitUpdate(std::uint32_t timeoutMs)
+{
+    std::unique_lock lock(mUpdateMutex);
+    return mUpdateDoneCond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() { return !mUpdateRunning; });
+}
+
+void WiiUPlatform::OnUpdateCompleted(std::int32_t result)
+{
+    UpdateCallback callback;
+    {
+        std::lock_guard lock(mUpdateMutex);
+        callback = std::exchange(mUpdateCallback, nullptr);
+    }
+
+    if (callback) {
+        callback(result);
+    }
+
+    // Wake up WaitUpdate right away, the callback results are visible to it by now
+    {
+        std::lock_guard lock(mUpdateMutex);
+        mUpdateRunning = false;
+    }
+    mUpdateDoneCond.notify_all();
+}
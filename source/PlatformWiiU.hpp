@@ -0,0 +1,74 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "Platform.hpp"
+#include <condition_variable>
+#include <mutex>
+
+// Platform implementation using the system libraries and Mocha
+class WiiUPlatform : public Platform {
+public:
+    WiiUPlatform();
+    virtual ~WiiUPlatform();
+
+    bool InitCCR() override;
+    void ExitCCR() override;
+    bool InitMocha() override;
+    void DeInitMocha() override;
+    bool MountMLC() override;
+    void UnmountMLC() override;
+    bool PatchIOS() override;
+
+    std::uint64_t GetTimeMs() override;
+    void SleepMs(std::uint32_t milliseconds) override;
+
+    bool GetDRCFirmwareTitlePath(std::string& path) override;
+
+    bool GetSoftwareVersion(Destination destination, SoftwareVersion& version) override;
+    bool GetExtId(ExtId ext, std::uint32_t& id) override;
+    bool SetCaffeineSlot(std::uint8_t slot) override;
+
+    bool ReadEeprom(std::uint32_t offset, std::span<std::uint8_t> data) override;
+    bool WriteEeprom(std::uint32_t offset, std::span<const std::uint8_t> data) override;
+    bool SetUicConfig(std::uint8_t configId, std::span<const std::uint8_t> data) override;
+    std::uint16_t CalcCRC16(std::span<const std::uint8_t> data) override;
+
+    bool GetDRCState(DRCState& state) override;
+    void InitReattach() override;
+    bool SetDRCState(DRCState state) override;
+    bool WaitReattach() override;
+
+    bool StartUpdate(const std::string& path, UpdateCallback callback) override;
+    bool AbortUpdate() override;
+    bool ActivateUpdate() override;
+    bool GetUpdateProgress(std::int32_t& progress) override;
+    bool WaitUpdate(std::uint32_t timeoutMs) override;
+
+    // Called by the software update callback
+    void OnUpdateCompleted(std::int32_t result);
+
+private:
+    // SetDRCState reads, modifies and writes back the whole state, which must not interleave
+    std::mutex mDRCStateMutex;
+
+    std::mutex mUpdateMutex;
+    UpdateCallback mUpdateCallback;
+    // Signalled by OnUpdateCompleted once the callback returned
+    std::condition_variable mUpdateDoneCond;
+    bool mUpdateRunning;
+};
@@ -0,0 +1,52 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "ProgressMessageBox.hpp"
+#include "Gfx.hpp"
+#include "Utils.hpp"
+#include <algorithm>
+
+ProgressMessageBox::ProgressMessageBox(const std::string& title, const std::string& message, const std::vector<Option> options, std::function<float(void)> progress)
+ : MessageBox(title, message, std::move(options)),
+   mProgress(std::move(progress))
+{
+}
+
+ProgressMessageBox::~ProgressMessageBox()
+{
+}
+
+void ProgressMessageBox::Draw()
+{
+    MessageBox::Draw();
+
+    float progress = std::clamp(mProgress(), 0.0f, 1.0f);
+
+    // Draw the progress bar above the options
+    int xOff = 128 + 16;
+    int yOff = Gfx::SCREEN_HEIGHT - 300 - 32 - 64;
+    int width = Gfx::SCREEN_WIDTH - 256 - 32;
+    Gfx::DrawRect(xOff, yOff, width, 64, 5, Gfx::COLOR_ACCENT);
+    Gfx::DrawRectFilled(xOff, yOff, width * progress, 64, Gfx::COLOR_ACCENT);
+
+    std::string text = progress < 1.0f ? Utils::sprintf("Verifying... %d%%", static_cast<int>(progress * 100.0f)) : "Ready";
+    Gfx::Print(Gfx::SCREEN_WIDTH / 2, yOff + 32, 40, Gfx::COLOR_TEXT, text, Gfx::ALIGN_CENTER);
+}
+
+bool ProgressMessageBox::IsOptionEnabled(size_t index) const
+{
+    return index == 0 || mProgress() >= 1.0f;
+}
@@ -0,0 +1,34 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "MessageBox.hpp"
+
+// Message box with a progress bar for work running in the background,
+// all options except the first one can only be selected once the progress reaches 1
+class ProgressMessageBox : public MessageBox {
+public:
+    ProgressMessageBox(const std::string& title, const std::string& message, const std::vector<Option> options, std::function<float(void)> progress);
+    virtual ~ProgressMessageBox();
+
+    virtual void Draw() override;
+
+protected:
+    virtual bool IsOptionEnabled(size_t index) const override;
+
+    std::function<float(void)> mProgress;
+};
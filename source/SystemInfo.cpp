@@ -0,0 +1,109 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "SystemInfo.hpp"
+#include "DRC.hpp"
+#include <mutex>
+
+namespace
+{
+
+// Queries may come from jobs as well as from the UI
+std::mutex cacheMutex;
+std::optional<std::string> cachedFirmwarePath;
+std::optional<SystemInfo::DRCInfo> cachedDRCInfo;
+
+std::optional<std::uint8_t> QueryEepromValue(Platform& platform, std::uint32_t offset)
+{
+    std::uint8_t value;
+    if (!DRC::GetEepromValue(platform, offset, std::span(&value, 1))) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+SystemInfo::DRCInfo QueryDRCInfo(Platform& platform)
+{
+    SystemInfo::DRCInfo info;
+
+    Platform::SoftwareVersion version;
+    if (platform.GetSoftwareVersion(Platform::Destination::DRC0, version)) {
+        info.drcVersion = version;
+    }
+
+    if (platform.GetSoftwareVersion(Platform::Destination::DRH, version)) {
+        info.drhVersion = version;
+    }
+
+    for (std::size_t i = 0; i < info.extIds.size(); i++) {
+        std::uint32_t extId;
+        if (platform.GetExtId(static_cast<Platform::ExtId>(i), extId)) {
+            info.extIds[i] = extId;
+        }
+    }
+
+    info.boardInfo = QueryEepromValue(platform, DRC::EEPROM_BOARD_INFO);
+    info.region = QueryEepromValue(platform, DRC::EEPROM_REGION);
+    info.deviceInfo = QueryEepromValue(platform, DRC::EEPROM_DEVICE_INFO);
+    return info;
+}
+
+}
+
+namespace SystemInfo
+{
+
+bool GetDRCFirmwarePath(std::string& path)
+{
+    std::lock_guard lock(cacheMutex);
+    if (!cachedFirmwarePath) {
+        std::string titlePath;
+        if (!Platform::GetDefault().GetDRCFirmwareTitlePath(titlePath)) {
+            return false;
+        }
+
+        cachedFirmwarePath = titlePath + "/content/drc_fw.bin";
+    }
+
+    path = *cachedFirmwarePath;
+    return true;
+}
+
+DRCInfo GetDRCInfo()
+{
+    std::lock_guard lock(cacheMutex);
+    if (cachedDRCInfo) {
+        return *cachedDRCInfo;
+    }
+
+    DRCInfo info = QueryDRCInfo(Platform::GetDefault());
+    // Don't keep incomplete results, the DRC might be reattaching or the EEPROM not read yet
+    if (info.drcVersion && info.boardInfo && info.region && info.deviceInfo) {
+        cachedDRCInfo = info;
+    }
+
+    return info;
+}
+
+void Invalidate()
+{
+    std::lock_guard lock(cacheMutex);
+    cachedFirmwarePath.reset();
+    cachedDRCInfo.reset();
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "Platform.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// Queries about the system the application is running on.
+// Results are cached for the session, call Invalidate after changing anything on the DRC.
+namespace SystemInfo
+{
+
+// Information about the DRC and DRH, values which couldn't be queried are empty
+struct DRCInfo {
+    std::optional<Platform::SoftwareVersion> drcVersion;
+    std::optional<Platform::SoftwareVersion> drhVersion;
+    // Indexed by Platform::ExtId
+    std::array<std::optional<std::uint32_t>, 5> extIds;
+
+    // Values from the cached EEPROM with a valid CRC
+    std::optional<std::uint8_t> boardInfo;
+    std::optional<std::uint8_t> region;
+    std::optional<std::uint8_t> deviceInfo;
+};
+
+// Get the path of the DRC firmware title installed on the system
+bool GetDRCFirmwarePath(std::string& path);
+
+DRCInfo GetDRCInfo();
+
+// Query everything again on the next call, needs to be called after flashing or writing to the EEPROM
+void Invalidate();
+
+}
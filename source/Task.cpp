@@ -0,0 +1,72 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Task.hpp"
+#include <utility>
+
+Task::Task()
+ : mHandle()
+{
+}
+
+Task::Task(std::coroutine_handle<promise_type> handle)
+ : mHandle(handle)
+{
+}
+
+Task::Task(Task&& other)
+ : mHandle(std::exchange(other.mHandle, nullptr))
+{
+}
+
+Task::~Task()
+{
+    if (mHandle) {
+        mHandle.destroy();
+    }
+}
+
+Task& Task::operator=(Task&& other)
+{
+    if (this != &other) {
+        if (mHandle) {
+            mHandle.destroy();
+        }
+
+        mHandle = std::exchange(other.mHandle, nullptr);
+    }
+
+    return *this;
+}
+
+bool Task::Update()
+{
+    if (IsDone()) {
+        return false;
+    }
+
+    promise_type& promise = mHandle.promise();
+    if (promise.waitCondition) {
+        if (!promise.waitCondition()) {
+            return true;
+        }
+
+        promise.waitCondition = nullptr;
+    }
+
+    mHandle.resume();
+    return !mHandle.done();
+}
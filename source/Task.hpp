@@ -0,0 +1,75 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "JobSystem.hpp"
+#include <coroutine>
+#include <exception>
+#include <functional>
+
+// Coroutine for long running operations, which is resumed from the frame loop.
+// Whenever the coroutine waits for something the frame loop keeps running,
+// so screens can keep drawing and handling input while the operation is in progress.
+class Task {
+public:
+    struct promise_type {
+        // The task is only resumed once this returns true, resumed on the next update if empty
+        std::function<bool(void)> waitCondition;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    template<typename T>
+    struct JobAwaiter {
+        JobFuture<T> future;
+
+        bool await_ready() { return future.IsReady(); }
+        void await_suspend(std::coroutine_handle<promise_type> handle)
+        {
+            handle.promise().waitCondition = [future = future]() { return future.IsReady(); };
+        }
+        T await_resume() { return future.Get(); }
+    };
+
+public:
+    Task();
+    Task(Task&& other);
+    virtual ~Task();
+
+    Task& operator=(Task&& other);
+
+    bool IsValid() const { return !!mHandle; }
+    bool IsDone() const { return !mHandle || mHandle.done(); }
+
+    // Resume the task if whatever it waits for is ready, returns false once the task has finished
+    bool Update();
+
+    // Wait until the next update
+    static std::suspend_always NextFrame() { return {}; }
+    // Wait for a job to finish and return its result
+    template<typename T>
+    static JobAwaiter<T> Await(JobFuture<T> future) { return { std::move(future) }; }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle);
+
+    std::coroutine_handle<promise_type> mHandle;
+};
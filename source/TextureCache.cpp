@@ -0,0 +1,78 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "TextureCache.hpp"
+#include "Gfx.hpp"
+
+TextureCache::TextureCache(std::size_t budget)
+ : mEntries(),
+   mLookup(),
+   mBudget(budget),
+   mSize(0)
+{
+}
+
+TextureCache::~TextureCache()
+{
+    Clear();
+}
+
+SDL_Texture* TextureCache::Get(std::uint32_t key)
+{
+    auto it = mLookup.find(key);
+    if (it == mLookup.end()) {
+        return nullptr;
+    }
+
+    mEntries.splice(mEntries.begin(), mEntries, it->second);
+    return it->second->texture;
+}
+
+void TextureCache::Insert(std::uint32_t key, SDL_Texture* texture, std::size_t size)
+{
+    auto it = mLookup.find(key);
+    if (it != mLookup.end()) {
+        Evict(it->second);
+    }
+
+    mEntries.push_front(Entry{key, texture, size});
+    mLookup.insert({key, mEntries.begin()});
+    mSize += size;
+
+    // Never evict the texture which was just inserted, even if it exceeds the budget on its own
+    while (mSize > mBudget && mEntries.size() > 1) {
+        Evict(std::prev(mEntries.end()));
+    }
+}
+
+void TextureCache::Clear()
+{
+    for (const Entry& entry : mEntries) {
+        Gfx::DestroyTexture(entry.texture);
+    }
+
+    mEntries.clear();
+    mLookup.clear();
+    mSize = 0;
+}
+
+void TextureCache::Evict(std::list<Entry>::iterator it)
+{
+    Gfx::DestroyTexture(it->texture);
+    mSize -= it->size;
+    mLookup.erase(it->key);
+    mEntries.erase(it);
+}
@@ -0,0 +1,59 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <SDL.h>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+// Least recently used cache of textures with a memory budget in bytes.
+// The cache owns the inserted textures and destroys them once they get evicted.
+class TextureCache {
+public:
+    TextureCache(std::size_t budget);
+    virtual ~TextureCache();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    // Returns nullptr if no texture with this key is cached, otherwise marks it as most recently used
+    SDL_Texture* Get(std::uint32_t key);
+
+    // Insert a texture taking size bytes, evicts the least recently used textures until the cache is within budget
+    void Insert(std::uint32_t key, SDL_Texture* texture, std::size_t size);
+
+    void Clear();
+
+    std::size_t GetSize() const { return mSize; }
+    std::size_t GetBudget() const { return mBudget; }
+
+private:
+    struct Entry {
+        std::uint32_t key;
+        SDL_Texture* texture;
+        std::size_t size;
+    };
+
+    void Evict(std::list<Entry>::iterator it);
+
+    // Most recently used entries are at the front
+    std::list<Entry> mEntries;
+    std::unordered_map<std::uint32_t, std::list<Entry>::iterator> mLookup;
+    std::size_t mBudget;
+    std::size_t mSize;
+};
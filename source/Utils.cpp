@@ -1,6 +1,23 @@
 #include "Utils.hpp"
+#include <array>
 #include <cstring>
 
+namespace
+{
+
+// Both hex characters of every byte value, so each byte is encoded with a single lookup
+constexpr std::array<char, 512> kHexPairTable = []() {
+    constexpr char digits[] = "0123456789abcdef";
+    std::array<char, 512> table{};
+    for (std::size_t i = 0; i < 256; i++) {
+        table[i * 2]     = digits[i >> 4];
+        table[i * 2 + 1] = digits[i & 0xf];
+    }
+    return table;
+}();
+
+}
+
 namespace Utils
 {
 
@@ -8,16 +25,40 @@ constexpr std::uint32_t CRCPOLY = 0xedb88320u;
 
 std::string ToHexString(const void* data, size_t size)
 {
-    std::string str;
-    for (size_t i = 0; i < size; ++i)
-        str += Utils::sprintf("%02x", ((const uint8_t*) data)[i]);
-    
+    std::string str(size * 2, '\0');
+    HexEncode(std::span(static_cast<const std::byte*>(data), size), str);
+
     return str;
 }
 
-std::uint32_t crc32(std::span<const std::byte> bytes)
+std::size_t HexEncode(std::span<const std::byte> bytes, std::span<char> out)
+{
+    if (out.size() < bytes.size() * 2) {
+        return 0;
+    }
+
+    const std::uint8_t* __restrict src = reinterpret_cast<const std::uint8_t*>(bytes.data());
+    char* __restrict dst = out.data();
+
+    // Encode 4 bytes per iteration, the table lookups are independent of each other
+    std::size_t i = 0;
+    for (; i + 4 <= bytes.size(); i += 4) {
+        std::memcpy(dst + i * 2,     &kHexPairTable[src[i] * 2],     2);
+        std::memcpy(dst + i * 2 + 2, &kHexPairTable[src[i + 1] * 2], 2);
+        std::memcpy(dst + i * 2 + 4, &kHexPairTable[src[i + 2] * 2], 2);
+        std::memcpy(dst + i * 2 + 6, &kHexPairTable[src[i + 3] * 2], 2);
+    }
+
+    for (; i < bytes.size(); i++) {
+        std::memcpy(dst + i * 2, &kHexPairTable[src[i] * 2], 2);
+    }
+
+    return bytes.size() * 2;
+}
+
+std::uint32_t crc32(std::span<const std::byte> bytes, std::uint32_t crc)
 {
-    std::uint32_t crc = 0xFFFFFFFFu;
+    crc = ~crc;
     
     for(std::size_t i = 0; i < bytes.size(); i++) {
         std::uint8_t ch = std::uint8_t(bytes[i]);
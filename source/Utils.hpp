@@ -20,6 +20,11 @@ std::string sprintf(const std::string& format, Args ...args)
 
 std::string ToHexString(const void* data, size_t size);
 
-std::uint32_t crc32(std::span<const std::byte> bytes);
+// Encode bytes as lowercase hex into out, which needs room for at least bytes.size() * 2 characters.
+// No null terminator is written, returns the amount of characters written or 0 if out is too small.
+std::size_t HexEncode(std::span<const std::byte> bytes, std::span<char> out);
+
+// Pass a previous result as crc to continue calculating over multiple buffers
+std::uint32_t crc32(std::span<const std::byte> bytes, std::uint32_t crc = 0);
 
 }
@@ -0,0 +1,52 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Wait.hpp"
+#include "Platform.hpp"
+#include <algorithm>
+
+namespace Wait
+{
+
+Result Until(Platform& platform, const std::function<bool(void)>& condition, const Options& options)
+{
+    const std::uint64_t startTime = platform.GetTimeMs();
+    const std::uint64_t deadline = startTime + options.timeoutMs;
+    std::uint32_t interval = options.initialIntervalMs;
+
+    Result result{};
+    while (true) {
+        result.attempts++;
+        if (condition()) {
+            result.success = true;
+            break;
+        }
+
+        const std::uint64_t now = platform.GetTimeMs();
+        if (now >= deadline) {
+            break;
+        }
+
+        // Don't sleep past the deadline, the condition is checked a last time once it is reached
+        platform.SleepMs(std::min<std::uint64_t>(interval, deadline - now));
+        interval = std::min(interval * 2, options.maxIntervalMs);
+    }
+
+    result.elapsedMs = platform.GetTimeMs() - startTime;
+    return result;
+}
+
+}
@@ -0,0 +1,48 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+class Platform;
+
+namespace Wait
+{
+
+struct Options {
+    // The condition is checked again after this interval, which doubles after every attempt
+    std::uint32_t initialIntervalMs = 10;
+    std::uint32_t maxIntervalMs = 200;
+    // Give up once the condition wasn't met for this long
+    std::uint32_t timeoutMs = 2000;
+};
+
+struct Result {
+    bool success;
+    std::uint32_t elapsedMs;
+    std::uint32_t attempts;
+
+    explicit operator bool() const { return success; }
+};
+
+// Block until condition returns true or the timeout expired.
+// Checks quickly at first and backs off exponentially, so short waits end as soon as possible
+// without polling long waits at a high rate.
+Result Until(Platform& platform, const std::function<bool(void)>& condition, const Options& options = {});
+
+}
@@ -1,48 +1,8 @@
 #include "EditDeviceInfoScreen.hpp"
 #include "Utils.hpp"
 #include "Gfx.hpp"
-
-#include <nsysccr/cdc.h>
-#include <nsysccr/cfg.h>
-
-namespace {
-
-bool SetDeviceInfo(uint8_t byte)
-{
-    CCRCDCUicConfig cfg{};
-    // custom config id which was added by the gamepad cfw
-    cfg.configId = 4;
-    // device info byte + crc16
-    cfg.size = 3;
-    cfg.data[0] = byte;
-    uint16_t crc = CCRCDCCalcCRC16(cfg.data, 1);
-    cfg.data[1] = crc & 0xff;
-    cfg.data[2] = (crc >> 8) & 0xff;
-    if (CCRCDCPerSetUicConfig(CCR_CDC_DESTINATION_DRC0, &cfg) != 0) {
-        return false;
-    }
-
-    // Also update the cached eeprom
-    return CCRCFGSetCachedEeprom(0, 0x106, cfg.data, cfg.size) == 0;
-}
-
-bool GetDeviceInfo(uint8_t& deviceInfo)
-{
-    uint8_t data[3];
-    if (CCRCFGGetCachedEeprom(0, 0x106, data, 3) != 0) {
-        return false;
-    }
-
-    uint16_t crc = (uint16_t) data[2] << 8 | data[1];
-    if (CCRCDCCalcCRC16(&data[0], 1) != crc) {
-        return false;
-    }
-
-    deviceInfo = data[0];
-    return true;
-}
-
-}
+#include "DRC.hpp"
+#include "SystemInfo.hpp"
 
 EditDeviceInfoScreen::EditDeviceInfoScreen()
  : mSelected(OPTION_ID_MIN),
@@ -145,7 +105,9 @@ bool EditDeviceInfoScreen::Update(VPADStatus& input)
     switch (mState)
     {
         case STATE_GET_DEVICE_INFO:
-            if (!GetDeviceInfo(mDeviceInfo)) {
+            if (auto deviceInfo = SystemInfo::GetDRCInfo().deviceInfo) {
+                mDeviceInfo = *deviceInfo;
+            } else {
                 mErrorText = "Failed to retrieve current device info.";
                 mState = STATE_ERROR;
                 break;
@@ -246,7 +208,9 @@ bool EditDeviceInfoScreen::Update(VPADStatus& input)
             newDeviceConfig |= 0x01;
         }
 
-        if (!SetDeviceInfo(newDeviceConfig)) {
+        bool success = DRC::SetEepromValue(Platform::GetDefault(), DRC::UIC_CONFIG_DEVICE_INFO, DRC::EEPROM_DEVICE_INFO, newDeviceConfig);
+        SystemInfo::Invalidate();
+        if (!success) {
             mErrorText = "Failed to set device info.\n(Is the firmware modified properly?)";
             mState = STATE_ERROR;
         } else {
@@ -3,72 +3,78 @@
 #include "ProcUI.hpp"
 #include "Utils.hpp"
 #include "Firmware.hpp"
+#include "FirmwareDatabase.hpp"
+#include "AllocStats.hpp"
+#include "PaletteQuantizer.hpp"
+#include "ProgressMessageBox.hpp"
+#include "Patches.hpp"
+#include "SystemInfo.hpp"
+#include "DRC.hpp"
+#include "Platform.hpp"
+#include <algorithm>
 #include <cstdio>
+#include <utility>
 
-#include <coreinit/mcp.h>
+#include <coreinit/debug.h>
 #include <coreinit/thread.h>
 #include <coreinit/filesystem_fsa.h>
-#include <nsysccr/cdc.h>
-#include <nsysccr/cfg.h>
-#include <nn/ccr.h>
+#include <png.h>
 
-namespace {
+#include <logo_overlay.h>
 
-#include "logo.inc"
+namespace {
 
-bool GetDRCFirmwarePath(std::string& path)
+// Returns a line describing the build of the image, or nothing if the build isn't in the database
+std::string DescribeBuild(const char* label, const FirmwareBlob::PeekResult& info)
 {
-    int32_t handle = MCP_Open();
-    if (handle < 0) {
-        return false;
-    }
-
-    alignas(0x40) MCPTitleListType title;
-    uint32_t titleCount = 0;
-    MCPError error = MCP_TitleListByAppType(handle, MCP_APP_TYPE_DRC_FIRMWARE, &titleCount, &title, sizeof(title));
-    MCP_Close(handle);
-
-    if (error != 0 || titleCount != 1) {
-        return false;
+    auto fingerprints = FirmwareDatabase::Fingerprint(info.sections, info.pageCRCs);
+    const FirmwareDatabase::Build* build = FirmwareDatabase::Identify(info.imageVersion, fingerprints);
+    if (!build) {
+        return {};
     }
 
-    path = std::string(&title.path[0]) + "/content/drc_fw.bin";
-    return true;
+    return Utils::sprintf("%s: %s (%s)\n", label, build->name, build->region);
 }
 
-bool ReadFirmwareHeader(const std::string& path, FlashScreen::FirmwareHeader& header)
+bool WriteFile(const std::string& path, const FirmwareSegments& segments)
 {
-    FILE* f = fopen(path.c_str(), "rb");
+    FILE* f = fopen(path.c_str(), "wb");
     if (!f) {
         return false;
     }
 
-    if (fread(&header, 1, sizeof(header), f) != sizeof(header)) {
-        fclose(f);
-        return false;
+    for (const auto& segment : segments) {
+        if (fwrite(segment.data(), 1, segment.size(), f) != segment.size()) {
+            fclose(f);
+            return false;
+        }
     }
 
     fclose(f);
     return true;
 }
 
-bool WriteFile(const std::string& path, std::span<const std::byte> data)
+bool LoadPNG(const std::string& path, std::vector<std::uint8_t>& rgba, std::uint32_t& width, std::uint32_t& height)
 {
-    FILE* f = fopen(path.c_str(), "wb");
-    if (!f) {
+    png_image image{};
+    image.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_file(&image, path.c_str())) {
         return false;
     }
 
-    if (fwrite(data.data(), 1, data.size(), f) != data.size()) {
-        fclose(f);
+    image.format = PNG_FORMAT_RGBA;
+    rgba.resize(PNG_IMAGE_SIZE(image));
+    if (!png_image_finish_read(&image, nullptr, rgba.data(), 0, nullptr)) {
+        png_image_free(&image);
         return false;
     }
 
-    fclose(f);
+    width = image.width;
+    height = image.height;
     return true;
 }
 
-bool CopyFile(const std::string& srcPath, const std::string& dstPath)
+bool CopyFile(const std::string& srcPath, const std::string& dstPath, std::atomic<std::size_t>& progress, const std::atomic<bool>& cancel)
 {
     FILE* inf = fopen(srcPath.c_str(), "rb");
     if (!inf) {
@@ -84,11 +90,13 @@ bool CopyFile(const std::string& srcPath, const std::string& dstPath)
     uint8_t buf[4096];
     size_t bytesRead;
     while ((bytesRead = fread(buf, 1, sizeof(buf), inf)) > 0) {
-        if (fwrite(buf, 1, bytesRead, outf) != bytesRead) {
+        if (cancel || fwrite(buf, 1, bytesRead, outf) != bytesRead) {
             fclose(inf);
             fclose(outf);
             return false;
         }
+
+        progress += bytesRead;
     }
 
     if (ferror(inf)) {
@@ -102,106 +110,13 @@ bool CopyFile(const std::string& srcPath, const std::string& dstPath)
     return true;
 }
 
-bool CaffeineInvalidate()
-{
-    CCRCDCSoftwareVersion version;
-    CCRCDCSoftwareGetVersion(CCR_CDC_DESTINATION_DRC0, &version);
-
-    // Only newer versions have caffeine
-    if (version.runningVersion >= 0x180a0000) {
-        return CCRSysCaffeineSetCaffeineSlot(0xff) == 0;
-    }
-
-    return true;
-}
-
-bool WaitForEeprom(uint32_t drcSlot)
-{
-    uint8_t val;
-    OSTime startTime = OSGetSystemTime();
-    while (CCRCFGGetCachedEeprom(drcSlot, 0, &val, sizeof(val)) == -1) {
-        // 2 second timeout
-        if (OSTicksToSeconds(OSGetSystemTime() - startTime) > 2) {
-            return false;
-        }
-
-        OSSleepTicks(OSMillisecondsToTicks(200));
-    }
-
-    return true;
-}
-
-bool ReattachDRC(CCRCDCDestination dest, CCRCDCDrcStateEnum targetState, BOOL unknown)
-{
-    // Get the current DRC state
-    CCRCDCDrcState state;
-    int32_t res = CCRCDCSysGetDrcState(dest, &state);
-    if (res != 0) {
-        return false;
-    }
-
-    if (state.state == CCR_CDC_DRC_STATE_STANDALONE) {
-        state.state = CCR_CDC_DRC_STATE_ACTIVE;
-    }
-
-    // Nothing to do if we're already in the target state
-    if (state.state == targetState) {
-        return true;
-    }
-
-    __CCRSysInitReattach(dest - CCR_CDC_DESTINATION_DRC0);
-
-    // Set target state
-    state.state = targetState;
-    res = CCRCDCSysSetDrcState(dest, &state);
-    if (res != 0) {
-        return false;
-    }
-
-    // Wait for the DRC to reattach
-    res = __CCRSysWaitReattach(dest - CCR_CDC_DESTINATION_DRC0, unknown);
-    if (res != 0) {
-        return false;
-    }
-
-    // Wait for EEPROM
-    if (!WaitForEeprom(dest - CCR_CDC_DESTINATION_DRC0)) {
-        return false;
-    }
-
-    // Check if we're in the state we want
-    res = CCRCDCSysGetDrcState(dest, &state);
-    if (res != 0) {
-        return false;
-    }
-
-    if (state.state != targetState) {
-        return false;
-    }
-
-    return true;
-}
-
-bool AbortUpdate(CCRCDCDestination dest)
+void ReportAllocStats(const char* name, const AllocStats::Scope& scope)
 {
-    OSTime startTime = OSGetSystemTime();
-    while (CCRCDCSoftwareAbort(dest) != 0) {
-        // 3 second timeout
-        if (OSTicksToSeconds(OSGetSystemTime() - startTime) > 3) {
-            return false;
-        }
-
-        OSSleepTicks(OSMillisecondsToTicks(200));
+    if constexpr (AllocStats::ENABLED) {
+        AllocStats::Counters counters = scope.Get();
+        OSReport("DRXUtil: %s: %u allocations, %u bytes, %u peak bytes\n", name,
+            unsigned(counters.allocations), unsigned(counters.bytes), unsigned(counters.peakBytes));
     }
-
-    return true;
-}
-
-void SoftwareUpdateCallback(IOSError error, void* arg)
-{
-    FlashScreen* flashScreen = static_cast<FlashScreen*>(arg);
-
-    flashScreen->OnUpdateCompleted(error);
 }
 
 }
@@ -210,20 +125,30 @@ FlashScreen::FlashScreen()
  : mFileEntries({
     {FILE_ORIGINAL, {0xf187, "Original Firmware"}},
     {FILE_BUILTIN,  {0xf462, "Built-in Firmware Patches"}},
+    {FILE_BUILTIN_STARTUP, {0xf03e, "Built-in Patches + \"sd:/drc_startup.png\""}},
     {FILE_SDCARD,   {0xf7c2, "From SD Card (\"sd:/drc_fw.bin\")"}},
  }),
  mErrorString(),
  mFirmwarePath(),
  mFirmwareHeader(),
  mFlashingProgress(0),
- mUpdateComplete(false),
- mUpdateResult(-1),
+ mFlashStage(DRC::FlashStage::PREPARE),
+ mFlashJob(),
+ mPrepareJob(),
+ mPrepareCancel(false),
+ mPrepareProgress(0),
+ mPrepareTotal(0),
  mMessageBox()
 {
 }
 
 FlashScreen::~FlashScreen()
 {
+    // The flash job reports to this screen, so it has to finish first
+    if (mFlashJob.IsValid()) {
+        mFlashJob.Wait();
+    }
+    StopPreparing();
 }
 
 void FlashScreen::Draw()
@@ -233,14 +158,16 @@ void FlashScreen::Draw()
     switch (mState)
     {
         case STATE_SELECT_FILE: {
+            // Fit all entries between the top and bottom bar
+            const int rowHeight = std::min<int>(150, (Gfx::SCREEN_HEIGHT - 75 * 2) / mFileEntries.size());
             for (FileID id = FILE_ORIGINAL; id <= FILE_SDCARD; id = static_cast<FileID>(id + 1)) {
-                int yOff = 75 + static_cast<int>(id) * 150;
-                Gfx::DrawRectFilled(0, yOff, Gfx::SCREEN_WIDTH, 150, Gfx::COLOR_ALT_BACKGROUND);
-                Gfx::DrawIcon(68, yOff + 150 / 2, 60, Gfx::COLOR_TEXT, mFileEntries[id].icon);
-                Gfx::Print(128 + 8, yOff + 150 / 2, 60, Gfx::COLOR_TEXT, mFileEntries[id].name, Gfx::ALIGN_VERTICAL);
+                int yOff = 75 + static_cast<int>(id) * rowHeight;
+                Gfx::DrawRectFilled(0, yOff, Gfx::SCREEN_WIDTH, rowHeight, Gfx::COLOR_ALT_BACKGROUND);
+                Gfx::DrawIcon(68, yOff + rowHeight / 2, 60, Gfx::COLOR_TEXT, mFileEntries[id].icon);
+                Gfx::Print(128 + 8, yOff + rowHeight / 2, 60, Gfx::COLOR_TEXT, mFileEntries[id].name, Gfx::ALIGN_VERTICAL);
 
                 if (id == mFile) {
-                    Gfx::DrawRect(0, yOff, Gfx::SCREEN_WIDTH, 150, 8, Gfx::COLOR_HIGHLIGHTED);
+                    Gfx::DrawRect(0, yOff, Gfx::SCREEN_WIDTH, rowHeight, 8, Gfx::COLOR_HIGHLIGHTED);
                 }
             }
             break;
@@ -254,9 +181,10 @@ void FlashScreen::Draw()
             break;
         }
         case STATE_FLASHING: {
-            Gfx::Print(Gfx::SCREEN_WIDTH / 2, Gfx::SCREEN_HEIGHT / 2 - 32, 64, Gfx::COLOR_TEXT, Utils::sprintf("Flashing... %d%%", mFlashingProgress), Gfx::ALIGN_CENTER);
+            const int32_t progress = mFlashingProgress;
+            Gfx::Print(Gfx::SCREEN_WIDTH / 2, Gfx::SCREEN_HEIGHT / 2 - 32, 64, Gfx::COLOR_TEXT, Utils::sprintf("Flashing... %d%%", progress), Gfx::ALIGN_CENTER);
             Gfx::DrawRect(64, Gfx::SCREEN_HEIGHT / 2 + 32, Gfx::SCREEN_WIDTH - 128, 64, 5, Gfx::COLOR_ACCENT);
-            Gfx::DrawRectFilled(64, Gfx::SCREEN_HEIGHT / 2 + 32, (Gfx::SCREEN_WIDTH - 128) * (mFlashingProgress / 100.0f), 64, Gfx::COLOR_ACCENT);
+            Gfx::DrawRectFilled(64, Gfx::SCREEN_HEIGHT / 2 + 32, (Gfx::SCREEN_WIDTH - 128) * (progress / 100.0f), 64, Gfx::COLOR_ACCENT);
             break;
         }
         case STATE_ACTIVATE: {
@@ -292,8 +220,18 @@ void FlashScreen::Draw()
 bool FlashScreen::Update(VPADStatus& input)
 {
     if (mMessageBox) {
+        // Close the confirmation if preparing the firmware failed in the background
+        if (mPrepareJob.IsValid() && mPrepareJob.IsReady() && !mPrepareJob.Get()) {
+            StopPreparing();
+            mMessageBox.reset();
+            mState = STATE_ERROR;
+            return true;
+        }
+
         if (!mMessageBox->Update(input)) {
             mMessageBox.reset();
+            // This cancels preparing if the message box was closed without selecting continue
+            StopPreparing();
         }
 
         return true;
@@ -337,7 +275,7 @@ bool FlashScreen::Update(VPADStatus& input)
         }
         case STATE_PREPARE: {
             std::string originalFirmwarePath;
-            if (!GetDRCFirmwarePath(originalFirmwarePath)) {
+            if (!SystemInfo::GetDRCFirmwarePath(originalFirmwarePath)) {
                 mErrorString = "Failed to get original DRC firmware path";
                 mState = STATE_ERROR;
                 break;
@@ -353,28 +291,70 @@ bool FlashScreen::Update(VPADStatus& input)
             std::string doptPath = originalFirmwarePath;
             doptPath.replace(prefixPos, sizeof("/vol/storage_mlc01") - 1, "storage_mlc01:");
 
-            FirmwareHeader originalFirmwareHeader;
-            if (!ReadFirmwareHeader(doptPath, originalFirmwareHeader)) {
+            FileStream originalStream(doptPath);
+            auto originalInfo = FirmwareBlob::Peek(originalStream);
+            if (!originalInfo) {
                 mErrorString = "Failed to read original DRC firmware header";
                 mState = STATE_ERROR;
                 break;
             }
 
+            FirmwareHeader originalFirmwareHeader;
+            originalFirmwareHeader.version            = originalInfo->imageVersion;
+            originalFirmwareHeader.blockSize          = originalInfo->blockSize;
+            originalFirmwareHeader.sequencePerSession = originalInfo->sequencePerSession;
+            originalFirmwareHeader.imageSize          = originalInfo->imageSize;
+
+            std::string build;
+
+            // Only the headers are checked here, everything else is done in the background
             if (mFile == FILE_ORIGINAL) {
                 mFirmwarePath = originalFirmwarePath;
                 mFirmwareHeader = originalFirmwareHeader;
-            } else if (mFile == FILE_BUILTIN) {
-                if (!PatchFirmware()) {
+                build = DescribeBuild("Build", *originalInfo);
+                StartPreparing(0, nullptr);
+            } else if (mFile == FILE_BUILTIN || mFile == FILE_BUILTIN_STARTUP) {
+                if (originalFirmwareHeader.version != Patches::BUILTIN_SOURCE_VERSION) {
+                    mErrorString = Utils::sprintf("Built-in patches require firmware version 0x%08x\n(Original 0x%08x)",
+                        Patches::BUILTIN_SOURCE_VERSION, originalFirmwareHeader.version);
                     mState = STATE_ERROR;
                     break;
                 }
+
+                // The remaining header fields are filled in once patching is done
+                mFirmwareHeader.version = Patches::BUILTIN_PATCHED_VERSION;
+                build = DescribeBuild("Based on", *originalInfo);
+                bool customStartupScreen = mFile == FILE_BUILTIN_STARTUP;
+                StartPreparing(sizeof(FirmwareHeader) + originalFirmwareHeader.imageSize, [this, customStartupScreen]() {
+                    return PatchFirmware(customStartupScreen);
+                });
             } else if (mFile == FILE_SDCARD) {
-                if (!ReadFirmwareHeader("/vol/external01/drc_fw.bin", mFirmwareHeader)) {
-                    mErrorString = "Failed to read DRC firmware header";
+                FileStream stream("/vol/external01/drc_fw.bin");
+                auto info = FirmwareBlob::Peek(stream);
+                if (!info) {
+                    mErrorString = "Failed to read DRC firmware header:\n" + info.error();
+                    mState = STATE_ERROR;
+                    break;
+                }
+
+                if (!info->headerCRCValid || !info->superCRCsValid) {
+                    mErrorString = "DRC firmware header is corrupted";
+                    mState = STATE_ERROR;
+                    break;
+                }
+
+                if (info->type != Firmware::Type::DRC) {
+                    mErrorString = Utils::sprintf("Not a DRC firmware image (type 0x%08x)", std::to_underlying(info->type));
                     mState = STATE_ERROR;
                     break;
                 }
 
+                mFirmwareHeader.version            = info->imageVersion;
+                mFirmwareHeader.blockSize          = info->blockSize;
+                mFirmwareHeader.sequencePerSession = info->sequencePerSession;
+                mFirmwareHeader.imageSize          = info->imageSize;
+                build = DescribeBuild("Build", *info);
+
                 // Don't allow downgrading lower than the version on NAND,
                 // otherwise this might cause bricks without flashing the language files?
                 if (mFirmwareHeader.version < originalFirmwareHeader.version) {
@@ -383,113 +363,54 @@ bool FlashScreen::Update(VPADStatus& input)
                     break;
                 }
 
-                // Copy to MLC so IOS-PAD can install it
-                mFirmwarePath = "/vol/storage_mlc01/usr/tmp/drc_fw.bin";
-                if (!CopyFile("/vol/external01/drc_fw.bin", "storage_mlc01:/usr/tmp/drc_fw.bin")) {
-                    mErrorString = "Failed to copy firmware to MLC";
-                    mState = STATE_ERROR;
-                    break;
-                }
+                // The image is read twice, once for verifying and once for copying
+                StartPreparing(2 * (sizeof(FirmwareHeader) + info->imageSize), [this]() {
+                    return VerifySDFirmware();
+                });
             } else {
                 mState = STATE_ERROR;
                 break;
             }
 
-            mMessageBox = std::make_unique<MessageBox>(
+            mMessageBox = std::make_unique<ProgressMessageBox>(
                 "Are you really really really sure?",
                 Utils::sprintf("About to flash firmware version 0x%08x.\n"
+                               "%s"
                                "Flashing a firmware can do permanent damage!!!\n",
-                               mFirmwareHeader.version),
+                               mFirmwareHeader.version, build.c_str()),
                 std::vector{
                     MessageBox::Option{0, "\ue001 Back", [this]() {} },
                     MessageBox::Option{0xf00c, "Continue", [this]() {
+                        mFlashTask = Flash();
                         mState = STATE_UPDATE;
                     }},
-                }
+                },
+                [this]() { return GetPrepareProgress(); }
             );
             // Go back to select file, if the message box closes without selecting continue
             mState = STATE_SELECT_FILE;
             break;
         }
-        case STATE_UPDATE: {
-            ProcUI::SetHomeButtonMenuEnabled(false);
-
-            if (!CaffeineInvalidate()) {
-                mErrorString = "Failed to invalidate caffeine.";
-                mState = STATE_ERROR;
-                break;  
-            }
-
-            // Abort any potential pending software updates
-            CCRCDCSoftwareAbort(CCR_CDC_DESTINATION_DRC0);
-
-            // Reattach the DRC in update mode
-            if (!ReattachDRC(CCR_CDC_DESTINATION_DRC0, CCR_CDC_DRC_STATE_FWUPDATE, FALSE)) {
-                ReattachDRC(CCR_CDC_DESTINATION_DRC0, CCR_CDC_DRC_STATE_ACTIVE, FALSE);
-                mErrorString = "Failed to reattach DRC in update mode.";
-                mState = STATE_ERROR;
-                break;  
-            }
-
-            mFlashingProgress = 0;
-            mUpdateComplete = false;
-            mUpdateResult = 0;
-            if (CCRCDCSoftwareUpdate(CCR_CDC_DESTINATION_DRC0, mFirmwarePath.c_str(), SoftwareUpdateCallback, this) != 0) {
-                AbortUpdate(CCR_CDC_DESTINATION_DRC0);
-                ReattachDRC(CCR_CDC_DESTINATION_DRC0, CCR_CDC_DRC_STATE_ACTIVE, FALSE);
-                mErrorString = "Failed to start software update.";
-                mState = STATE_ERROR;
-                break;  
-            }
-
-            mState = STATE_FLASHING;
-            break;
-        }
-        case STATE_FLASHING: {
-            // Update progress
-            CCRCDCFWInfo fwInfo{};
-            if (CCRCDCGetFWInfo(CCR_CDC_DESTINATION_DRC0, &fwInfo) == 0) {
-                mFlashingProgress = fwInfo.updateProgress;
-            }
-
-            OSSleepTicks(OSMillisecondsToTicks(200));
-
-            // Check if update complete
-            if (mUpdateComplete) {
-                if (mUpdateResult == IOS_ERROR_OK) {
-                    mState = STATE_ACTIVATE;
-                } else {
-                    AbortUpdate(CCR_CDC_DESTINATION_DRC0);
-                    ReattachDRC(CCR_CDC_DESTINATION_DRC0, CCR_CDC_DRC_STATE_ACTIVE, FALSE);
-                    mErrorString = "Software update failed.";
-                    mState = STATE_ERROR;
-                }
-            }
-            break;
-        }
+        case STATE_UPDATE:
+        case STATE_FLASHING:
         case STATE_ACTIVATE: {
-            // Activate the newly flashed firmware
-            if (CCRCDCSoftwareActivate(CCR_CDC_DESTINATION_DRC0) != 0) {
-                AbortUpdate(CCR_CDC_DESTINATION_DRC0);
-                ReattachDRC(CCR_CDC_DESTINATION_DRC0, CCR_CDC_DRC_STATE_ACTIVE, FALSE);
-                mErrorString = "Failed to activate software update.";
-                mState = STATE_ERROR;
-                break;  
-            }
-
-            // Put the gamepad back into active mode
-            OSTime startTime = OSGetSystemTime();
-            while (!ReattachDRC(CCR_CDC_DESTINATION_DRC0, CCR_CDC_DRC_STATE_ACTIVE, FALSE)) {
-                // 10 second timeout
-                if (OSTicksToSeconds(OSGetSystemTime() - startTime) > 10) {
-                    // At this point we don't really care if it times out or not
+            // Show the stage the flash job is in, the task sets the final state once it's done
+            switch (mFlashStage.load()) {
+                case DRC::FlashStage::PREPARE:
+                    mState = STATE_UPDATE;
+                    break;
+                case DRC::FlashStage::FLASH:
+                    mState = STATE_FLASHING;
+                    break;
+                case DRC::FlashStage::ACTIVATE:
+                    mState = STATE_ACTIVATE;
                     break;
-                }
-
-                OSSleepTicks(OSMillisecondsToTicks(1000));
             }
 
-            mState = STATE_DONE;
+            if (!mFlashTask.Update()) {
+                // Versions and the EEPROM might have changed, even if flashing failed
+                SystemInfo::Invalidate();
+            }
             break;
         }
         case STATE_ERROR:
@@ -508,16 +429,45 @@ bool FlashScreen::Update(VPADStatus& input)
     return true;
 }
 
-void FlashScreen::OnUpdateCompleted(int32_t result)
+Task FlashScreen::Flash()
 {
-    mUpdateComplete = true;
-    mUpdateResult = result;
+    ProcUI::SetHomeButtonMenuEnabled(false);
+
+    mFlashingProgress = 0;
+    mFlashStage = DRC::FlashStage::PREPARE;
+
+    // Flashing waits on the DRC until it rebooted into the new firmware, which takes about a minute
+    mFlashJob = JobSystem::GetDefault().SubmitBlocking([this]() {
+        DRC::FlashHooks hooks;
+        hooks.onStage = [this](DRC::FlashStage stage) { mFlashStage = stage; };
+        hooks.onProgress = [this](int32_t progress) { mFlashingProgress = progress; };
+
+        return DRC::Flash(Platform::GetDefault(), mFirmwarePath, hooks);
+    });
+
+    auto result = co_await Task::Await(mFlashJob);
+    if (!result) {
+        mErrorString = result.error();
+        mState = STATE_ERROR;
+        co_return;
+    }
+
+    mState = STATE_DONE;
 }
 
-bool FlashScreen::PatchFirmware()
+bool FlashScreen::PatchFirmware(bool customStartupScreen)
 {
+    // Load the custom startup screen first, so a missing image fails before doing any work
+    std::vector<std::uint8_t> startupImage;
+    std::uint32_t startupImageWidth = 0;
+    std::uint32_t startupImageHeight = 0;
+    if (customStartupScreen && !LoadPNG("/vol/external01/drc_startup.png", startupImage, startupImageWidth, startupImageHeight)) {
+        mErrorString = "Failed to load \"sd:/drc_startup.png\"";
+        return false;
+    }
+
     std::string firmwarePath;
-    if (!GetDRCFirmwarePath(firmwarePath)) {
+    if (!SystemInfo::GetDRCFirmwarePath(firmwarePath)) {
         mErrorString = "Failed to get firmware path for patching";
         return false;
     }
@@ -528,83 +478,70 @@ bool FlashScreen::PatchFirmware()
         return false;
     }
 
-    auto blob = FirmwareBlob::FromStream(stream);
+    AllocStats::Scope parseStats;
+    ProgressStream progressStream(stream, mPrepareProgress, mPrepareCancel);
+    auto blob = FirmwareBlob::FromStream(progressStream);
     if (!blob) {
         mErrorString = "Failed to parse firmware\n" + blob.error();
         return false;
     }
+    ReportAllocStats("parse", parseStats);
 
-    if (blob->GetImageVersion() != 0x190c0117) {
-        mErrorString = "Invalid image version to patch";
+    AllocStats::Scope patchStats;
+    auto patched = Patches::ApplyBuiltin(*blob);
+    if (!patched) {
+        mErrorString = patched.error();
         return false;
     }
+    ReportAllocStats("patch", patchStats);
 
-    // Patch the LVC section
-    auto lvc = blob->GetFirmware().GetSection<GenericSection>("LVC_");
-    if (lvc) {
-        if (Utils::crc32(lvc->ToBytes()) != 0x82d87264) {
-            mErrorString = "Invalid LVC checksum";
-            return false;
-        }
-
-        // Patch jumptable to make ID 1 valid
-        lvc->WriteAt<std::uint8_t> (0x0003c9c4, 0x30);
-        // Patch config table at offset 1 to insert region
-        lvc->WriteAt<std::uint32_t>(0x000b28d0, 0x3);   // size
-        lvc->WriteAt<std::uint32_t>(0x000b28d4, 0x103); // eeprom offset
-
-        // Patch jumptable to make ID 4 valid
-        lvc->WriteAt<std::uint8_t> (0x0003c9c7, 0x30);
-        // Patch config table at offset 4 to insert board config
-        lvc->WriteAt<std::uint32_t>(0x000b28e8, 0x3);   // size
-        lvc->WriteAt<std::uint32_t>(0x000b28ec, 0x106); // eeprom offset
-    } else {
-        mErrorString = "LVC section not found in firmware";
+    // ApplyBuiltin already made sure the startup screen exists
+    auto startupScreen = blob->GetFirmware().GetSection<ResourceSection>("IMG_")->GetResource<BitmapResource>(Patches::STARTUP_SCREEN_ID);
+    if (startupImageWidth > startupScreen->GetWidth() || startupImageHeight > startupScreen->GetHeight()) {
+        mErrorString = Utils::sprintf("Startup screen image can't be larger than %ux%u",
+            startupScreen->GetWidth(), startupScreen->GetHeight());
         return false;
     }
 
-    // Add "Modified Firmware" logo to startup screen in resource section
-    auto img = blob->GetFirmware().GetSection<ResourceSection>("IMG_");
-    if (img) {
-        auto startupScreen = img->GetResource<BitmapResource>(0x2001);
-        if (startupScreen) {
-            startupScreen->BlendBitmapBits(logo, 103u, 400u, 48u);
-        } else {
-            mErrorString = "Startup screen not found";
-            return false;
-        }
-    } else {
-        mErrorString = "IMG section not found";
-        return false;
-    }
+    AllocStats::Scope serializeStats;
+    // Section data is written straight from the firmware, without building the whole image in memory
+    auto patchedSegments = blob->ToSegments();
+    ReportAllocStats("serialize", serializeStats);
 
-    // Patch version in version section
-    auto ver = blob->GetFirmware().GetSection<GenericSection>("VER_");
-    if (ver) {
-        ver->WriteAt<std::uint32_t>(0, 0xfe000000);
-    } else {
-        mErrorString = "Version section not found";
+// This check can be disabled when experimenting with patches
+#if 1
+    std::uint32_t crc = 0;
+    for (const auto& segment : patchedSegments) {
+        crc = Utils::crc32(segment, crc);
+    }
+    if (!Patches::IsKnownPatchedCRC(crc)) {
+        mErrorString = "Patched file CRC doesn't match";
         return false;
     }
+#endif
+
+    // The custom startup screen is applied after the CRC check, since the result can't be known in advance
+    if (customStartupScreen) {
+        std::vector<std::uint8_t> pixels(startupImageWidth * startupImageHeight);
+        PaletteQuantizer quantizer(startupScreen->GetPalette());
+        if (!quantizer.Quantize(startupImage, pixels)) {
+            mErrorString = "Failed to convert startup screen image";
+            return false;
+        }
 
-    blob->SetImageVersion(0xfe000000);
+        startupScreen->BlendBitmap(pixels, startupImageWidth, startupImageHeight);
+        // Keep the logo on top, so a modified firmware can always be recognized
+        startupScreen->BlendOverlay(logo_overlay);
 
-    auto patchedBytes = blob->ToBytes();
+        patchedSegments = blob->ToSegments();
+    }
 
-// This check can be disabled when experimenting with patches
-#if 1
-    std::uint32_t crc = Utils::crc32(patchedBytes);
-    if (crc != 0xd13694f3 && // JPN
-        crc != 0xb0aed5b6 && // USA
-        crc != 0x2d177dfb)   // EUR
-    {
-        mErrorString = "Patched file CRC doesn't match";
+    if (mPrepareCancel) {
         return false;
     }
-#endif
 
     mFirmwarePath = "/vol/storage_mlc01/usr/tmp/drc_fw.bin";
-    if (!WriteFile("storage_mlc01:/usr/tmp/drc_fw.bin", patchedBytes)) {
+    if (!WriteFile("storage_mlc01:/usr/tmp/drc_fw.bin", patchedSegments)) {
         mErrorString = "Failed to write temporary file to MLC";
         return false;
     }
@@ -612,7 +549,76 @@ bool FlashScreen::PatchFirmware()
     mFirmwareHeader.version            = blob->GetImageVersion();
     mFirmwareHeader.blockSize          = blob->GetBlockSize();
     mFirmwareHeader.sequencePerSession = blob->GetSequencePerSession();
-    mFirmwareHeader.imageSize          = patchedBytes.size() - sizeof(mFirmwareHeader);
+    mFirmwareHeader.imageSize          = patchedSegments.GetSize() - sizeof(mFirmwareHeader);
+
+    return true;
+}
+
+bool FlashScreen::VerifySDFirmware()
+{
+    FileStream stream("/vol/external01/drc_fw.bin");
+    if (stream.GetError() != Stream::ERROR_OK) {
+        mErrorString = "Failed to open firmware for verifying";
+        return false;
+    }
+
+    // Check all sub-CRCs in one pass, the image doesn't need to be parsed into sections for that
+    ProgressStream progressStream(stream, mPrepareProgress, mPrepareCancel);
+    auto verified = FirmwareBlob::Verify(progressStream);
+    if (!verified) {
+        mErrorString = "Failed to verify firmware\n" + verified.error();
+        return false;
+    }
+
+    // Copy to MLC so IOS-PAD can install it
+    mFirmwarePath = "/vol/storage_mlc01/usr/tmp/drc_fw.bin";
+    if (!CopyFile("/vol/external01/drc_fw.bin", "storage_mlc01:/usr/tmp/drc_fw.bin", mPrepareProgress, mPrepareCancel)) {
+        mErrorString = "Failed to copy firmware to MLC";
+        return false;
+    }
 
     return true;
 }
+
+void FlashScreen::StartPreparing(std::size_t total, std::function<bool(void)> task)
+{
+    StopPreparing();
+
+    mPrepareCancel = false;
+    mPrepareProgress = 0;
+    mPrepareTotal = total;
+
+    // Nothing to prepare, so the confirmation can continue right away
+    if (!task) {
+        task = []() { return true; };
+    }
+
+    mPrepareJob = JobSystem::GetDefault().Submit(std::move(task));
+}
+
+void FlashScreen::StopPreparing()
+{
+    if (mPrepareJob.IsValid()) {
+        mPrepareCancel = true;
+        mPrepareJob.Wait();
+        mPrepareJob = {};
+    }
+}
+
+float FlashScreen::GetPrepareProgress() const
+{
+    if (!mPrepareJob.IsValid()) {
+        return 0.0f;
+    }
+
+    if (mPrepareJob.IsReady()) {
+        return mPrepareJob.Get() ? 1.0f : 0.0f;
+    }
+
+    if (mPrepareTotal == 0) {
+        return 0.0f;
+    }
+
+    // Don't report completion before the job actually finished
+    return std::min(static_cast<float>(mPrepareProgress) / mPrepareTotal, 0.99f);
+}
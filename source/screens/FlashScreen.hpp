@@ -2,6 +2,12 @@
 
 #include "Screen.hpp"
 #include "MessageBox.hpp"
+#include "JobSystem.hpp"
+#include "Task.hpp"
+#include "DRC.hpp"
+#include <atomic>
+#include <expected>
+#include <functional>
 #include <map>
 #include <memory>
 
@@ -23,10 +29,15 @@ public:
 
     bool Update(VPADStatus& input);
 
-    void OnUpdateCompleted(int32_t result);
-
 private:
-    bool PatchFirmware();
+    Task Flash();
+    bool PatchFirmware(bool customStartupScreen);
+    bool VerifySDFirmware();
+
+    // The firmware is verified and prepared on the job system, while the confirmation is shown
+    void StartPreparing(std::size_t total, std::function<bool(void)> task);
+    void StopPreparing();
+    float GetPrepareProgress() const;
 
     enum State {
         STATE_SELECT_FILE,
@@ -41,6 +52,7 @@ private:
     enum FileID {
         FILE_ORIGINAL,
         FILE_BUILTIN,
+        FILE_BUILTIN_STARTUP,
         FILE_SDCARD,
     } mFile = FILE_ORIGINAL;
     struct FileEntry {
@@ -53,9 +65,16 @@ private:
     std::string mFirmwarePath;
     FirmwareHeader mFirmwareHeader;
 
-    int32_t mFlashingProgress;
-    bool mUpdateComplete;
-    int32_t mUpdateResult;
-    
+    // Published by the flash job, see Flash
+    std::atomic<int32_t> mFlashingProgress;
+    std::atomic<DRC::FlashStage> mFlashStage;
+    JobFuture<std::expected<void, std::string>> mFlashJob;
+    Task mFlashTask;
+
+    JobFuture<bool> mPrepareJob;
+    std::atomic<bool> mPrepareCancel;
+    std::atomic<std::size_t> mPrepareProgress;
+    std::size_t mPrepareTotal;
+
     std::unique_ptr<MessageBox> mMessageBox;
 };
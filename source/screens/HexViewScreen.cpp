@@ -0,0 +1,125 @@
+#include "HexViewScreen.hpp"
+#include "Gfx.hpp"
+#include "Utils.hpp"
+#include <algorithm>
+#include <array>
+
+HexViewScreen::HexViewScreen(std::string name, std::span<const std::byte> data)
+ : mName(std::move(name)),
+   mOwnedData(),
+   mData(data),
+   mScroll(0),
+   mHoldFrames(0),
+   mRowBuffer()
+{
+}
+
+HexViewScreen::HexViewScreen(std::string name, std::vector<std::byte>&& data)
+ : mName(std::move(name)),
+   mOwnedData(std::move(data)),
+   mData(mOwnedData),
+   mScroll(0),
+   mHoldFrames(0),
+   mRowBuffer()
+{
+}
+
+HexViewScreen::~HexViewScreen()
+{
+}
+
+void HexViewScreen::Draw()
+{
+    DrawTopBar("HexViewScreen");
+
+    int yOff = 75 + 16;
+    Gfx::Print(32, yOff + ROW_HEIGHT / 2, 40, Gfx::COLOR_TEXT, mName, Gfx::ALIGN_VERTICAL);
+    Gfx::Print(Gfx::SCREEN_WIDTH - 32, yOff + ROW_HEIGHT / 2, 40, Gfx::COLOR_ALT_TEXT,
+        Utils::sprintf("%u bytes", unsigned(mData.size())), Gfx::ALIGN_VERTICAL | Gfx::ALIGN_RIGHT);
+    yOff += ROW_HEIGHT + 16;
+    Gfx::DrawRectFilled(0, yOff - 8, Gfx::SCREEN_WIDTH, 4, Gfx::COLOR_ACCENT);
+
+    // Only the visible rows are formatted
+    const std::size_t end = std::min<std::size_t>(mScroll + VISIBLE_ROWS, GetRowCount());
+    for (std::size_t row = mScroll; row < end; row++) {
+        FormatRow(row, mRowBuffer);
+        Gfx::Print(64, yOff, FONT_SIZE, Gfx::COLOR_TEXT, mRowBuffer, Gfx::ALIGN_LEFT | Gfx::ALIGN_TOP, true);
+        yOff += ROW_HEIGHT;
+    }
+
+    DrawBottomBar("\ue07d Scroll / \ue083\ue084 Page / \ue07e 4K", nullptr, "\ue001 Back");
+}
+
+bool HexViewScreen::Update(VPADStatus& input)
+{
+    if (input.trigger & VPAD_BUTTON_B) {
+        return false;
+    }
+
+    // Scroll continuously while up/down are held
+    if (input.hold & (VPAD_BUTTON_UP | VPAD_BUTTON_DOWN)) {
+        mHoldFrames++;
+    } else {
+        mHoldFrames = 0;
+    }
+    const bool repeat = mHoldFrames > REPEAT_DELAY;
+
+    if ((input.trigger & VPAD_BUTTON_DOWN) || (repeat && (input.hold & VPAD_BUTTON_DOWN))) {
+        Scroll(1);
+    } else if ((input.trigger & VPAD_BUTTON_UP) || (repeat && (input.hold & VPAD_BUTTON_UP))) {
+        Scroll(-1);
+    } else if (input.trigger & VPAD_BUTTON_R) {
+        Scroll(VISIBLE_ROWS);
+    } else if (input.trigger & VPAD_BUTTON_L) {
+        Scroll(-VISIBLE_ROWS);
+    } else if (input.trigger & VPAD_BUTTON_RIGHT) {
+        Scroll(0x1000 / BYTES_PER_ROW);
+    } else if (input.trigger & VPAD_BUTTON_LEFT) {
+        Scroll(-0x1000 / std::ptrdiff_t(BYTES_PER_ROW));
+    }
+
+    return true;
+}
+
+void HexViewScreen::FormatRow(std::size_t row, std::string& out) const
+{
+    // "oooooooo  xx xx xx xx xx xx xx xx  xx xx xx xx xx xx xx xx  |................|"
+    constexpr std::size_t HEX_START = 10;
+    constexpr std::size_t ASCII_START = HEX_START + BYTES_PER_ROW * 3 + 3;
+    out.assign(ASCII_START + BYTES_PER_ROW + 1, ' ');
+
+    const std::size_t offset = row * BYTES_PER_ROW;
+    const std::array<std::byte, 4> offsetBytes = {
+        std::byte(offset >> 24), std::byte(offset >> 16), std::byte(offset >> 8), std::byte(offset)
+    };
+    Utils::HexEncode(offsetBytes, std::span(out).first(8));
+
+    std::span<const std::byte> bytes = mData.subspan(offset, std::min(BYTES_PER_ROW, mData.size() - offset));
+    std::array<char, BYTES_PER_ROW * 2> hex;
+    Utils::HexEncode(bytes, hex);
+
+    out[ASCII_START - 1] = '|';
+    for (std::size_t i = 0; i < bytes.size(); i++) {
+        // Extra gap after the first 8 bytes
+        const std::size_t pos = HEX_START + i * 3 + (i >= BYTES_PER_ROW / 2 ? 1 : 0);
+        out[pos]     = hex[i * 2];
+        out[pos + 1] = hex[i * 2 + 1];
+
+        const char c = static_cast<char>(bytes[i]);
+        out[ASCII_START + i] = (c >= 0x20 && c < 0x7f) ? c : '.';
+    }
+    out[ASCII_START + bytes.size()] = '|';
+    out.resize(ASCII_START + bytes.size() + 1);
+}
+
+void HexViewScreen::Scroll(std::ptrdiff_t rows)
+{
+    const std::size_t rowCount = GetRowCount();
+    const std::size_t maxScroll = rowCount > VISIBLE_ROWS ? rowCount - VISIBLE_ROWS : 0;
+
+    if (rows < 0) {
+        mScroll = std::size_t(-rows) > mScroll ? 0 : mScroll + rows;
+    } else {
+        mScroll = std::min(mScroll + rows, maxScroll);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Screen.hpp"
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+class HexViewScreen : public Screen
+{
+public:
+    // data must stay alive for the lifetime of the screen
+    HexViewScreen(std::string name, std::span<const std::byte> data);
+    HexViewScreen(std::string name, std::vector<std::byte>&& data);
+    virtual ~HexViewScreen();
+
+    void Draw();
+
+    bool Update(VPADStatus& input);
+
+private:
+    static constexpr std::size_t BYTES_PER_ROW = 16;
+    static constexpr int VISIBLE_ROWS = 24;
+    static constexpr int ROW_HEIGHT = 36;
+    static constexpr int FONT_SIZE = 28;
+    // Frames a direction has to be held before it starts repeating
+    static constexpr int REPEAT_DELAY = 20;
+
+    std::size_t GetRowCount() const { return (mData.size() + BYTES_PER_ROW - 1) / BYTES_PER_ROW; }
+    void FormatRow(std::size_t row, std::string& out) const;
+    void Scroll(std::ptrdiff_t rows);
+
+    std::string mName;
+    std::vector<std::byte> mOwnedData;
+    std::span<const std::byte> mData;
+
+    std::size_t mScroll;
+    int mHoldFrames;
+
+    // Reused for formatting rows to avoid allocating every frame
+    std::string mRowBuffer;
+};
@@ -1,25 +1,28 @@
 #include "MainScreen.hpp"
 #include "MenuScreen.hpp"
 #include "Gfx.hpp"
+#include "Platform.hpp"
 
 #include <vector>
 
-#include <mocha/mocha.h>
-#include <coreinit/filesystem_fsa.h>
-#include <nn/ccr.h>
+MainScreen::MainScreen()
+ : mInitTask(Initialize())
+{
+}
 
 MainScreen::~MainScreen()
 {
+    Platform& platform = Platform::GetDefault();
     if (mState > STATE_INIT_CCR_SYS) {
-        CCRSysExit();
+        platform.ExitCCR();
     }
 
     if (mState > STATE_MOUNT_FS) {
-        Mocha_UnmountFS("storage_mlc01");
+        platform.UnmountMLC();
     }
 
     if (mState > STATE_INIT_MOCHA) {
-        Mocha_DeInitLibrary();
+        platform.DeInitMocha();
     }
 }
 
@@ -88,66 +91,49 @@ bool MainScreen::Update(VPADStatus& input)
         return false;
     }
 
-    MochaUtilsStatus status;
-    switch (mState) {
-    case STATE_INIT:
-        mState = STATE_INIT_CCR_SYS;
-        break;
-    case STATE_INIT_CCR_SYS:
-        CCRSysInit();
-        mState = STATE_INIT_MOCHA;
-        break;
-    case STATE_INIT_MOCHA:
-        status = Mocha_InitLibrary();
-        if (status != MOCHA_RESULT_SUCCESS) {
-            mStateFailure = true;
-            break;
-        }
+    mInitTask.Update();
+    return true;
+}
 
-        mState = STATE_MOUNT_FS;
-        break;
-    case STATE_MOUNT_FS:
-        // We need access to the MLC to read/write DRC firmware
-        status = Mocha_MountFS("storage_mlc01", nullptr, "/vol/storage_mlc01");
-        if (status != MOCHA_RESULT_SUCCESS) {
-            mStateFailure = true;
-            break;
-        }
-        
-        mState = STATE_PATCH_IOS;
-        break;
-    case STATE_PATCH_IOS:
-        uint32_t op;
-        if (Mocha_IOSUKernelRead32(0x11f53cf4, &op) != MOCHA_RESULT_SUCCESS) {
-            mStateFailure = true;
-            break;
-        }
+Task MainScreen::Initialize()
+{
+    // Wait a frame after every state change, so the status is visible while the step runs
+    mState = STATE_INIT_CCR_SYS;
+    co_await Task::NextFrame();
 
-        if (op == 0xeb00bd82) {
-            // nop IOSU version check
-            status = Mocha_IOSUKernelWrite32(0x11f53cf4, 0xe3a00001);
-            if (status != MOCHA_RESULT_SUCCESS) {
-                mStateFailure = true;
-                break;
-            }
-        } else if (op == 0xe3a00001) {
-            // already patched
-        } else {
-            mStateFailure = true;
-            break;
-        }
+    Platform& platform = Platform::GetDefault();
+    platform.InitCCR();
 
-        mState = STATE_LOAD_MENU;
-        break;
-    case STATE_LOAD_MENU:
-        mMenuScreen = std::make_unique<MenuScreen>();
-        mState = STATE_IN_MENU;
-        break;
-    case STATE_IN_MENU:
-        break;
-    };
+    mState = STATE_INIT_MOCHA;
+    co_await Task::NextFrame();
 
-    return true;
+    if (!platform.InitMocha()) {
+        mStateFailure = true;
+        co_return;
+    }
+
+    mState = STATE_MOUNT_FS;
+    co_await Task::NextFrame();
+
+    // We need access to the MLC to read/write DRC firmware
+    if (!platform.MountMLC()) {
+        mStateFailure = true;
+        co_return;
+    }
+
+    mState = STATE_PATCH_IOS;
+    co_await Task::NextFrame();
+
+    if (!platform.PatchIOS()) {
+        mStateFailure = true;
+        co_return;
+    }
+
+    mState = STATE_LOAD_MENU;
+    co_await Task::NextFrame();
+
+    mMenuScreen = std::make_unique<MenuScreen>();
+    mState = STATE_IN_MENU;
 }
 
 void MainScreen::DrawStatus(std::string status, SDL_Color color)
@@ -2,12 +2,13 @@
 
 #include "Screen.hpp"
 #include "Gfx.hpp"
+#include "Task.hpp"
 #include <memory>
 
 class MainScreen : public Screen
 {
 public:
-    MainScreen() = default;
+    MainScreen();
     virtual ~MainScreen();
 
     void Draw();
@@ -17,6 +18,8 @@ public:
 protected:
     void DrawStatus(std::string status, SDL_Color color = Gfx::COLOR_TEXT);
 
+    Task Initialize();
+
 private:
     enum {
         STATE_INIT,
@@ -29,5 +32,7 @@ private:
     } mState = STATE_INIT;
     bool mStateFailure = false;
 
+    Task mInitTask;
+
     std::unique_ptr<Screen> mMenuScreen;
 };
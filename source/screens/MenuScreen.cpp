@@ -3,6 +3,7 @@
 #include "AboutScreen.hpp"
 #include "FlashScreen.hpp"
 #include "InfoScreen.hpp"
+#include "ResourceBrowserScreen.hpp"
 #include "SetRegionScreen.hpp"
 #include "EditDeviceInfoScreen.hpp"
 
@@ -12,6 +13,7 @@ MenuScreen::MenuScreen()
  : mEntries({
         { MENU_ID_INFO,             { 0xf085, "Show DRC/DRH information" }},
         { MENU_ID_FLASH,            { 0xf1c9, "Flash firmware" }},
+        { MENU_ID_BROWSE_FIRMWARE,  { 0xf5fd, "Browse firmware resources" }},
         { MENU_ID_SET_REGION,       { 0xf0ac, "Set region" }},
         { MENU_ID_EDIT_DEVICE_INFO, { 0xf1de, "Edit device info" }},
         { MENU_ID_ABOUT,            { 0xf05a, "About DRXUtil" }},
@@ -77,6 +79,9 @@ bool MenuScreen::Update(VPADStatus& input)
         case MENU_ID_FLASH:
             mSubscreen = std::make_unique<FlashScreen>();
             break;
+        case MENU_ID_BROWSE_FIRMWARE:
+            mSubscreen = std::make_unique<ResourceBrowserScreen>();
+            break;
         case MENU_ID_SET_REGION:
             mSubscreen = std::make_unique<SetRegionScreen>();
             break;
@@ -20,6 +20,7 @@ private:
     enum MenuID {
         MENU_ID_INFO,
         MENU_ID_FLASH,
+        MENU_ID_BROWSE_FIRMWARE,
         MENU_ID_SET_REGION,
         MENU_ID_EDIT_DEVICE_INFO,
         MENU_ID_ABOUT,
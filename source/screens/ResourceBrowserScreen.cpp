@@ -0,0 +1,286 @@
+#include "ResourceBrowserScreen.hpp"
+#include "Gfx.hpp"
+#include "HexViewScreen.hpp"
+#include "Utils.hpp"
+#include "SystemInfo.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+const char* GetResourceTypeName(Resource::Type type)
+{
+    switch (type) {
+    case Resource::Type::BITMAP:
+        return "Bitmap";
+    case Resource::Type::SOUND:
+        return "Sound";
+    default:
+        return "Unknown";
+    }
+}
+
+std::string GetResourceDetails(const Resource::Descriptor& descriptor)
+{
+    switch (descriptor.type) {
+    case Resource::Type::BITMAP:
+        return Utils::sprintf("%ux%u, format %u, %u bytes",
+            descriptor.parameters.bitmap.width, descriptor.parameters.bitmap.height,
+            descriptor.parameters.bitmap.format, descriptor.size);
+    case Resource::Type::SOUND:
+        return Utils::sprintf("%u Hz, %u bit, %u channels, %u bytes",
+            descriptor.parameters.sound.frequency, descriptor.parameters.sound.bits,
+            descriptor.parameters.sound.channels, descriptor.size);
+    default:
+        return Utils::sprintf("%u bytes", descriptor.size);
+    }
+}
+
+}
+
+ResourceBrowserScreen::ResourceBrowserScreen()
+ : mSubscreen(),
+   mBlob(),
+   mEntries(),
+   mSelected(0),
+   mScroll(0),
+   mThumbnails(THUMBNAIL_BUDGET),
+   mErrorString()
+{
+}
+
+ResourceBrowserScreen::~ResourceBrowserScreen()
+{
+}
+
+void ResourceBrowserScreen::Draw()
+{
+    if (mSubscreen) {
+        mSubscreen->Draw();
+        return;
+    }
+
+    DrawTopBar("ResourceBrowserScreen");
+
+    switch (mState)
+    {
+        case STATE_INIT:
+        case STATE_LOAD: {
+            Gfx::Print(Gfx::SCREEN_WIDTH / 2, Gfx::SCREEN_HEIGHT / 2, 64, Gfx::COLOR_TEXT, "Loading firmware...", Gfx::ALIGN_CENTER);
+            break;
+        }
+        case STATE_BROWSE: {
+            int decodes = 0;
+            const std::uint32_t end = std::min<std::uint32_t>(mScroll + VISIBLE_ROWS, mEntries.size());
+            for (std::uint32_t i = mScroll; i < end; i++) {
+                const Entry& entry = mEntries[i];
+                const int yOff = 75 + 1 + static_cast<int>(i - mScroll) * ROW_HEIGHT;
+                const bool isResource = entry.descriptor != nullptr;
+
+                Gfx::DrawRectFilled(0, yOff, Gfx::SCREEN_WIDTH, ROW_HEIGHT, isResource ? Gfx::COLOR_ALT_BACKGROUND : Gfx::COLOR_BARS);
+
+                const int thumbnailX = 32 + THUMBNAIL_WIDTH / 2;
+                const int centerY = yOff + ROW_HEIGHT / 2;
+                if (!isResource) {
+                    Gfx::DrawIcon(thumbnailX, centerY, 60, Gfx::COLOR_TEXT, 0xf07b);
+                } else if (entry.descriptor->type == Resource::Type::BITMAP) {
+                    // Only visible bitmaps are decoded, limited to a few per frame
+                    SDL_Texture* thumbnail = mThumbnails.Get(i);
+                    if (!thumbnail && decodes < MAX_DECODES_PER_FRAME) {
+                        thumbnail = DecodeThumbnail(i);
+                        decodes++;
+                    }
+
+                    if (thumbnail) {
+                        Gfx::DrawTexture(thumbnailX, centerY, thumbnail, Gfx::ALIGN_CENTER);
+                    } else {
+                        Gfx::DrawIcon(thumbnailX, centerY, 50, Gfx::COLOR_ALT_TEXT, 0xf03e);
+                    }
+                } else {
+                    Gfx::DrawIcon(thumbnailX, centerY, 50, Gfx::COLOR_ALT_TEXT, entry.descriptor->type == Resource::Type::SOUND ? 0xf028 : 0xf15b);
+                }
+
+                Gfx::Print(32 + THUMBNAIL_WIDTH + 32, centerY - 22, 48, Gfx::COLOR_TEXT, entry.name, Gfx::ALIGN_VERTICAL);
+                Gfx::Print(32 + THUMBNAIL_WIDTH + 32, centerY + 26, 40, Gfx::COLOR_ALT_TEXT, entry.details, Gfx::ALIGN_VERTICAL);
+
+                if (i == mSelected) {
+                    Gfx::DrawRect(0, yOff, Gfx::SCREEN_WIDTH, ROW_HEIGHT, 8, Gfx::COLOR_HIGHLIGHTED);
+                }
+            }
+            break;
+        }
+        case STATE_ERROR: {
+            Gfx::Print(Gfx::SCREEN_WIDTH / 2, Gfx::SCREEN_HEIGHT / 2, 64, Gfx::COLOR_ERROR, "Error:\n" + mErrorString, Gfx::ALIGN_CENTER);
+            break;
+        }
+    }
+
+    if (mState == STATE_BROWSE) {
+        DrawBottomBar("\ue07d Navigate / \ue083\ue084 Page / \ue000 Hex view", Utils::sprintf("%u / %u", mSelected + 1, unsigned(mEntries.size())).c_str(), "\ue001 Back");
+    } else if (mState == STATE_ERROR) {
+        DrawBottomBar(nullptr, nullptr, "\ue001 Back");
+    } else {
+        DrawBottomBar(nullptr, "Please wait...", nullptr);
+    }
+}
+
+bool ResourceBrowserScreen::Update(VPADStatus& input)
+{
+    if (mSubscreen) {
+        if (!mSubscreen->Update(input)) {
+            mSubscreen.reset();
+        }
+        return true;
+    }
+
+    switch (mState)
+    {
+        case STATE_INIT: {
+            // Wait a frame so the loading message gets drawn before loading blocks
+            mState = STATE_LOAD;
+            break;
+        }
+        case STATE_LOAD: {
+            mState = LoadFirmware() ? STATE_BROWSE : STATE_ERROR;
+            break;
+        }
+        case STATE_BROWSE: {
+            if (input.trigger & VPAD_BUTTON_B) {
+                return false;
+            }
+
+            if (input.trigger & VPAD_BUTTON_A) {
+                mSubscreen = OpenHexView(mEntries[mSelected]);
+                break;
+            }
+
+            const std::uint32_t count = mEntries.size();
+            if (input.trigger & VPAD_BUTTON_DOWN) {
+                mSelected = std::min(mSelected + 1, count - 1);
+            } else if (input.trigger & VPAD_BUTTON_UP) {
+                mSelected = mSelected > 0 ? mSelected - 1 : 0;
+            } else if (input.trigger & VPAD_BUTTON_R) {
+                mSelected = std::min<std::uint32_t>(mSelected + VISIBLE_ROWS, count - 1);
+            } else if (input.trigger & VPAD_BUTTON_L) {
+                mSelected = mSelected > VISIBLE_ROWS ? mSelected - VISIBLE_ROWS : 0;
+            }
+
+            // Keep the selection visible
+            if (mSelected < mScroll) {
+                mScroll = mSelected;
+            } else if (mSelected >= mScroll + VISIBLE_ROWS) {
+                mScroll = mSelected - VISIBLE_ROWS + 1;
+            }
+            break;
+        }
+        case STATE_ERROR: {
+            if (input.trigger & VPAD_BUTTON_B) {
+                return false;
+            }
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool ResourceBrowserScreen::LoadFirmware()
+{
+    std::string firmwarePath;
+    if (!SystemInfo::GetDRCFirmwarePath(firmwarePath)) {
+        mErrorString = "Failed to get firmware path";
+        return false;
+    }
+
+    FileStream stream(firmwarePath);
+    if (stream.GetError() != Stream::ERROR_OK) {
+        mErrorString = "Failed to open firmware";
+        return false;
+    }
+
+    auto blob = FirmwareBlob::FromStream(stream);
+    if (!blob) {
+        mErrorString = "Failed to parse firmware\n" + blob.error();
+        return false;
+    }
+    mBlob = std::move(*blob);
+
+    for (const auto& section : mBlob.GetFirmware()) {
+        const std::string sectionName(section->GetName().begin(), section->GetName().end());
+        auto resourceSection = std::dynamic_pointer_cast<ResourceSection>(section);
+
+        Entry& sectionEntry = mEntries.emplace_back(section, nullptr, nullptr, sectionName, "");
+        sectionEntry.details = Utils::sprintf("Version 0x%08x, %u bytes", section->GetVersion(), unsigned(section->SerializedSize()));
+        if (!resourceSection) {
+            continue;
+        }
+
+        sectionEntry.details += Utils::sprintf(", %u resources",
+            unsigned(std::distance(resourceSection->begin(), resourceSection->end())));
+
+        for (const Resource::Descriptor& descriptor : *resourceSection) {
+            mEntries.emplace_back(section, resourceSection, &descriptor,
+                Utils::sprintf("%s 0x%04x", GetResourceTypeName(descriptor.type), descriptor.id),
+                GetResourceDetails(descriptor));
+        }
+    }
+
+    if (mEntries.empty()) {
+        mErrorString = "Firmware doesn't contain any sections";
+        return false;
+    }
+
+    return true;
+}
+
+SDL_Texture* ResourceBrowserScreen::DecodeThumbnail(std::uint32_t index)
+{
+    const Entry& entry = mEntries[index];
+    auto bitmap = entry.resourceSection->GetResource<BitmapResource>(entry.descriptor->id);
+    if (!bitmap || bitmap->GetWidth() == 0 || bitmap->GetHeight() == 0) {
+        return nullptr;
+    }
+
+    // Scale down to fit into the thumbnail area while keeping the aspect ratio
+    const std::uint32_t width = bitmap->GetWidth();
+    const std::uint32_t height = bitmap->GetHeight();
+    const float scale = std::min({1.0f, float(THUMBNAIL_WIDTH) / width, float(THUMBNAIL_HEIGHT) / height});
+    const std::uint32_t thumbnailWidth = std::max<std::uint32_t>(1, width * scale);
+    const std::uint32_t thumbnailHeight = std::max<std::uint32_t>(1, height * scale);
+
+    // The palette alpha doesn't matter for how the firmware draws the bitmap, so show all pixels opaque
+    constexpr std::uint32_t OPAQUE = std::bit_cast<std::uint32_t>(std::array<std::uint8_t, 4>{0, 0, 0, 0xff});
+
+    std::vector<std::uint32_t> row(width);
+    std::vector<std::uint32_t> pixels(thumbnailWidth * thumbnailHeight);
+    for (std::uint32_t y = 0; y < thumbnailHeight; y++) {
+        if (!bitmap->ExpandRowToRGBA(y * height / thumbnailHeight, row)) {
+            return nullptr;
+        }
+
+        for (std::uint32_t x = 0; x < thumbnailWidth; x++) {
+            pixels[y * thumbnailWidth + x] = row[x * width / thumbnailWidth] | OPAQUE;
+        }
+    }
+
+    SDL_Texture* texture = Gfx::CreateTexture(thumbnailWidth, thumbnailHeight, pixels.data(), thumbnailWidth);
+    if (texture) {
+        mThumbnails.Insert(index, texture, pixels.size() * sizeof(std::uint32_t));
+    }
+
+    return texture;
+}
+
+std::unique_ptr<Screen> ResourceBrowserScreen::OpenHexView(const Entry& entry)
+{
+    if (entry.descriptor) {
+        return std::make_unique<HexViewScreen>(entry.name, entry.resourceSection->GetResourceData(*entry.descriptor));
+    }
+
+    // Generic sections can be viewed in place, other sections need to be packed first
+    if (auto generic = std::dynamic_pointer_cast<GenericSection>(entry.section)) {
+        return std::make_unique<HexViewScreen>(entry.name, generic->GetData());
+    }
+
+    return std::make_unique<HexViewScreen>(entry.name, entry.section->ToBytes());
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Screen.hpp"
+#include "Firmware.hpp"
+#include "TextureCache.hpp"
+#include <memory>
+#include <vector>
+
+class ResourceBrowserScreen : public Screen
+{
+public:
+    ResourceBrowserScreen();
+    virtual ~ResourceBrowserScreen();
+
+    void Draw();
+
+    bool Update(VPADStatus& input);
+
+private:
+    static constexpr int ROW_HEIGHT = 116;
+    static constexpr int VISIBLE_ROWS = 8;
+    static constexpr int THUMBNAIL_WIDTH = 176;
+    static constexpr int THUMBNAIL_HEIGHT = 100;
+    // Decoding is spread across frames to keep scrolling smooth
+    static constexpr int MAX_DECODES_PER_FRAME = 2;
+    static constexpr std::size_t THUMBNAIL_BUDGET = 4 * 1024 * 1024;
+
+    bool LoadFirmware();
+    SDL_Texture* DecodeThumbnail(std::uint32_t index);
+
+    enum State {
+        STATE_INIT,
+        STATE_LOAD,
+        STATE_BROWSE,
+        STATE_ERROR,
+    } mState = STATE_INIT;
+
+    // A row in the list, either a section or a resource inside of a resource section
+    struct Entry {
+        std::shared_ptr<FirmwareSection> section;
+        // Only set for resources
+        std::shared_ptr<ResourceSection> resourceSection;
+        const Resource::Descriptor* descriptor;
+
+        std::string name;
+        std::string details;
+    };
+
+    std::unique_ptr<Screen> OpenHexView(const Entry& entry);
+
+    std::unique_ptr<Screen> mSubscreen;
+
+    FirmwareBlob mBlob;
+    std::vector<Entry> mEntries;
+    std::uint32_t mSelected;
+    std::uint32_t mScroll;
+
+    TextureCache mThumbnails;
+
+    std::string mErrorString;
+};
@@ -1,32 +1,8 @@
 #include "SetRegionScreen.hpp"
 #include "Utils.hpp"
 #include "Gfx.hpp"
-
-#include <nsysccr/cdc.h>
-#include <nsysccr/cfg.h>
-
-namespace {
-
-bool SetRegionByte(uint8_t byte)
-{
-    CCRCDCUicConfig cfg{};
-    // custom config id which was added by the gamepad cfw
-    cfg.configId = 1;
-    // region byte + crc16
-    cfg.size = 3;
-    cfg.data[0] = byte;
-    uint16_t crc = CCRCDCCalcCRC16(cfg.data, 1);
-    cfg.data[1] = crc & 0xff;
-    cfg.data[2] = (crc >> 8) & 0xff;
-    if (CCRCDCPerSetUicConfig(CCR_CDC_DESTINATION_DRC0, &cfg) != 0) {
-        return false;
-    }
-
-    // Also update the cached eeprom
-    return CCRCFGSetCachedEeprom(0, 0x103, cfg.data, cfg.size) == 0;
-}
-
-}
+#include "DRC.hpp"
+#include "SystemInfo.hpp"
 
 SetRegionScreen::SetRegionScreen()
  : mRegionEntries({
@@ -124,14 +100,17 @@ bool SetRegionScreen::Update(VPADStatus& input)
                 break;
             }
             break;
-        case STATE_UPDATE:
-            if (!SetRegionByte(static_cast<uint8_t>(mRegion))) {
+        case STATE_UPDATE: {
+            bool success = DRC::SetEepromValue(Platform::GetDefault(), DRC::UIC_CONFIG_REGION, DRC::EEPROM_REGION, static_cast<uint8_t>(mRegion));
+            SystemInfo::Invalidate();
+            if (!success) {
                 mState = STATE_ERROR;
                 break;
             }
             
             mState = STATE_DONE;
             break;
+        }
         case STATE_DONE:
         case STATE_ERROR:
             if (input.trigger & VPAD_BUTTON_B) {
@@ -310,3 +310,116 @@ std::size_t SpanStream::GetRemaining() const
 
     return mSpan.size() - mPosition;
 }
+
+MutableSpanStream::MutableSpanStream(std::span<std::byte> span, std::endian endianness)
+ : Stream(endianness), mSpan(std::move(span)), mPosition(0)
+{
+}
+
+MutableSpanStream::~MutableSpanStream()
+{
+}
+
+std::size_t MutableSpanStream::Read(const std::span<std::byte>& data)
+{
+    if (data.size() > GetRemaining()) {
+        SetError(ERROR_READ_FAILED);
+        return 0;
+    }
+
+    std::copy_n(mSpan.begin() + mPosition, data.size(), data.begin());
+    mPosition += data.size();
+    return data.size();
+}
+
+std::size_t MutableSpanStream::Write(const std::span<const std::byte>& data)
+{
+    // The span cannot grow, so fail if not enough bytes remain
+    if (data.size() > GetRemaining()) {
+        SetError(ERROR_WRITE_FAILED);
+        return 0;
+    }
+
+    std::copy(data.begin(), data.end(), mSpan.begin() + mPosition);
+    mPosition += data.size();
+    return data.size();
+}
+
+bool MutableSpanStream::SetPosition(std::size_t position)
+{
+    if (position >= mSpan.size()) {
+        return false;
+    }
+
+    mPosition = position;
+    return true;
+}
+
+std::size_t MutableSpanStream::GetPosition() const
+{
+    return mPosition;
+}
+
+std::size_t MutableSpanStream::GetRemaining() const
+{
+    if (mPosition > mSpan.size()) {
+        return 0;
+    }
+
+    return mSpan.size() - mPosition;
+}
+
+ProgressStream::ProgressStream(Stream& stream, std::atomic<std::size_t>& progress, const std::atomic<bool>& cancel, std::endian endianness)
+ : Stream(endianness), mStream(stream), mProgress(progress), mCancel(cancel)
+{
+}
+
+ProgressStream::~ProgressStream()
+{
+}
+
+std::size_t ProgressStream::Read(const std::span<std::byte>& data)
+{
+    if (mCancel.get()) {
+        SetError(ERROR_READ_FAILED);
+        return 0;
+    }
+
+    std::size_t read = mStream.get().Read(data);
+    if (read != data.size()) {
+        SetError(ERROR_READ_FAILED);
+    }
+
+    // Seeking back to already read data doesn't count as progress
+    std::size_t position = mStream.get().GetPosition();
+    if (position > mProgress.get()) {
+        mProgress.get() = position;
+    }
+
+    return read;
+}
+
+std::size_t ProgressStream::Write(const std::span<const std::byte>& data)
+{
+    std::size_t written = mStream.get().Write(data);
+    if (written != data.size()) {
+        SetError(ERROR_WRITE_FAILED);
+    }
+
+    return written;
+}
+
+bool ProgressStream::SetPosition(std::size_t position)
+{
+    return mStream.get().SetPosition(position);
+}
+
+std::size_t ProgressStream::GetPosition() const
+{
+    return mStream.get().GetPosition();
+}
+
+std::size_t ProgressStream::GetRemaining() const
+{
+    return mStream.get().GetRemaining();
+}
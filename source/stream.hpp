@@ -16,6 +16,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <bit>
 #include <cstdint>
 #include <cstdio>
@@ -195,3 +196,42 @@ private:
     std::span<const std::byte> mSpan;
     std::size_t mPosition;
 };
+
+class MutableSpanStream : public Stream {
+public:
+    MutableSpanStream(std::span<std::byte> span, std::endian endianness = std::endian::native);
+    virtual ~MutableSpanStream();
+
+    virtual std::size_t Read(const std::span<std::byte>& data) override;
+    virtual std::size_t Write(const std::span<const std::byte>& data) override;
+
+    virtual bool SetPosition(std::size_t position) override;
+    virtual std::size_t GetPosition() const override;
+
+    virtual std::size_t GetRemaining() const override;
+
+private:
+    std::span<std::byte> mSpan;
+    std::size_t mPosition;
+};
+
+// Forwards to another stream and publishes the furthest position read so far,
+// reads fail once cancel is set so long running parses can be aborted from another thread
+class ProgressStream : public Stream {
+public:
+    ProgressStream(Stream& stream, std::atomic<std::size_t>& progress, const std::atomic<bool>& cancel, std::endian endianness = std::endian::native);
+    virtual ~ProgressStream();
+
+    virtual std::size_t Read(const std::span<std::byte>& data) override;
+    virtual std::size_t Write(const std::span<const std::byte>& data) override;
+
+    virtual bool SetPosition(std::size_t position) override;
+    virtual std::size_t GetPosition() const override;
+
+    virtual std::size_t GetRemaining() const override;
+
+private:
+    std::reference_wrapper<Stream> mStream;
+    std::reference_wrapper<std::atomic<std::size_t>> mProgress;
+    std::reference_wrapper<const std::atomic<bool>> mCancel;
+};
@@ -0,0 +1,297 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Commands.hpp"
+#include "AllocStats.hpp"
+#include "FileUtils.hpp"
+#include "Firmware.hpp"
+#include "Patches.hpp"
+#include "PatchesTesting.hpp"
+#include "SyntheticFirmware.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <optional>
+
+namespace
+{
+
+// Exposes the protected packing steps of Firmware
+class BenchFirmware : public Firmware {
+public:
+    BenchFirmware(const Firmware& firmware) : Firmware(firmware) {}
+
+    using Firmware::PackedSectionsSize;
+    using Firmware::PackSections;
+};
+
+struct BenchResult {
+    std::string name;
+    std::size_t iterations;
+    double minMs;
+    double medianMs;
+    double meanMs;
+    // Throughput based on the median time, empty if the benchmark doesn't process a meaningful amount of bytes
+    std::optional<double> mbPerSec;
+    // Per iteration
+    AllocStats::Counters allocations;
+};
+
+// Run body for the given amount of iterations, setup runs before every iteration and isn't measured.
+// bytes is the amount of data body processes, 0 if no throughput should be reported.
+BenchResult Run(const std::string& name, std::size_t iterations, std::size_t bytes,
+                const std::function<void()>& setup, const std::function<void()>& body)
+{
+    std::vector<double> times;
+    AllocStats::Counters allocations{};
+    for (std::size_t i = 0; i < iterations; i++) {
+        setup();
+
+        AllocStats::Scope scope;
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+        // Allocations are deterministic, so keep the ones from the last iteration
+        allocations = scope.Get();
+    }
+
+    std::sort(times.begin(), times.end());
+    BenchResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.minMs = times.front();
+    result.medianMs = times[times.size() / 2];
+    result.meanMs = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+    if (bytes) {
+        result.mbPerSec = bytes / (result.medianMs / 1000.0) / 1e6;
+    }
+    result.allocations = allocations;
+    return result;
+}
+
+std::expected<FirmwareBlob, std::string> Parse(std::span<const std::byte> image)
+{
+    SpanStream stream(image);
+    return FirmwareBlob::FromStream(stream);
+}
+
+void PrintBenchUsage()
+{
+    std::printf("Usage: drxfw bench [options] [image]\n\n");
+    std::printf("Benchmarks parsing, patching and serializing an image. Without an image a synthetic one is generated.\n\n");
+    std::printf("Options:\n");
+    std::printf("  --iterations <n>   Iterations per benchmark (default 10)\n");
+    std::printf("  --json <file>      Write the results as JSON\n");
+    std::printf("  --seed <n>         Seed of the synthetic image (default 1)\n");
+    std::printf("  --size <n>         Size of the synthetic image in bytes, K and M suffixes are allowed\n");
+}
+
+std::string EscapeJSON(const std::string& str)
+{
+    std::string escaped;
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += Utils::sprintf("\\u%04x", c);
+        } else {
+            escaped += c;
+        }
+    }
+
+    return escaped;
+}
+
+bool WriteJSON(const std::string& path, const std::string& input, std::size_t imageSize, const std::vector<BenchResult>& results)
+{
+    std::string json = "{\n";
+    json += Utils::sprintf("  \"input\": \"%s\",\n", EscapeJSON(input).c_str());
+    json += Utils::sprintf("  \"imageSize\": %zu,\n", imageSize);
+    json += Utils::sprintf("  \"allocStats\": %s,\n", AllocStats::ENABLED ? "true" : "false");
+    json += "  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const BenchResult& result = results[i];
+        json += "    {\n";
+        json += Utils::sprintf("      \"name\": \"%s\",\n", result.name.c_str());
+        json += Utils::sprintf("      \"iterations\": %zu,\n", result.iterations);
+        json += Utils::sprintf("      \"minMs\": %.4f,\n", result.minMs);
+        json += Utils::sprintf("      \"medianMs\": %.4f,\n", result.medianMs);
+        json += Utils::sprintf("      \"meanMs\": %.4f,\n", result.meanMs);
+        json += result.mbPerSec ? Utils::sprintf("      \"mbPerSec\": %.2f,\n", *result.mbPerSec) : "      \"mbPerSec\": null,\n";
+        json += Utils::sprintf("      \"allocations\": %zu,\n", result.allocations.allocations);
+        json += Utils::sprintf("      \"allocatedBytes\": %zu,\n", result.allocations.bytes);
+        json += Utils::sprintf("      \"peakBytes\": %zu\n", result.allocations.peakBytes);
+        json += i + 1 < results.size() ? "    },\n" : "    }\n";
+    }
+    json += "  ]\n}\n";
+
+    return WriteFile(path, std::as_bytes(std::span(json)));
+}
+
+}
+
+int RunBench(int argc, char** argv)
+{
+    std::size_t iterations = 10;
+    std::string jsonPath;
+    std::string imagePath;
+    SyntheticFirmwareConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--help") {
+            PrintBenchUsage();
+            return EXIT_SUCCESS;
+        } else if (arg == "--iterations" && hasValue) {
+            iterations = std::max(1ul, std::strtoul(argv[++i], nullptr, 0));
+        } else if (arg == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = std::strtoull(argv[++i], nullptr, 0);
+        } else if (arg == "--size" && hasValue) {
+            if (!ParseSize(argv[++i], config.targetSize)) {
+                std::fprintf(stderr, "Invalid size '%s'\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (!arg.starts_with("-") && imagePath.empty()) {
+            imagePath = arg;
+        } else {
+            std::fprintf(stderr, "Invalid argument '%s'\n\n", arg.c_str());
+            PrintBenchUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<std::byte> image;
+    std::string input;
+    if (!imagePath.empty()) {
+        if (!ReadFile(imagePath, image)) {
+            std::fprintf(stderr, "Failed to read '%s'\n", imagePath.c_str());
+            return EXIT_FAILURE;
+        }
+        input = imagePath;
+    } else {
+        auto generated = GenerateSyntheticFirmware(config);
+        if (!generated) {
+            std::fprintf(stderr, "Failed to generate image: %s\n", generated.error().c_str());
+            return EXIT_FAILURE;
+        }
+        image = std::move(*generated);
+        input = Utils::sprintf("synthetic seed %llu", (unsigned long long) config.seed);
+    }
+
+    auto reference = Parse(image);
+    if (!reference) {
+        std::fprintf(stderr, "Failed to parse image: %s\n", reference.error().c_str());
+        return EXIT_FAILURE;
+    }
+
+    auto img = reference->GetFirmware().GetSection<ResourceSection>("IMG_");
+    const std::vector<std::byte> imgBytes = img ? img->ToBytes() : std::vector<std::byte>();
+
+    // Real images are checked like in DRXUtil, synthetic ones can only be patched unchecked
+    const bool patchChecked = Patches::CheckBuiltin(*reference).has_value();
+
+    std::vector<BenchResult> results;
+    const auto none = []() {};
+
+    if (!imagePath.empty()) {
+        results.push_back(Run("FirmwareBlob::FromStream (file)", iterations, image.size(), none, [&]() {
+            FileStream stream(imagePath);
+            auto blob = FirmwareBlob::FromStream(stream);
+        }));
+    }
+
+    results.push_back(Run("FirmwareBlob::FromStream (span)", iterations, image.size(), none, [&]() {
+        auto blob = Parse(image);
+    }));
+
+    if (img) {
+        results.push_back(Run("ResourceSection::FromBytes", iterations, imgBytes.size(), none, [&]() {
+            auto section = ResourceSection::FromBytes(img->GetName(), img->GetVersion(), imgBytes);
+        }));
+
+        results.push_back(Run("ResourceSection::ToBytes", iterations, imgBytes.size(), none, [&]() {
+            auto bytes = img->ToBytes();
+        }));
+    }
+
+    BenchFirmware firmware(reference->GetFirmware());
+    std::vector<std::byte> packed(firmware.PackedSectionsSize());
+    results.push_back(Run("Firmware::PackSections", iterations, packed.size(), none, [&]() {
+        firmware.PackSections(packed);
+    }));
+
+    results.push_back(Run("FirmwareBlob::ToBytes", iterations, image.size(), none, [&]() {
+        auto bytes = reference->ToBytes();
+    }));
+
+    results.push_back(Run("FirmwareBlob::ToSegments", iterations, image.size(), none, [&]() {
+        auto segments = reference->ToSegments();
+    }));
+
+    // Sections are shared between copies of a blob, so every iteration patches a freshly parsed one.
+    // Patching only writes a few bytes, so there is no throughput for it.
+    std::optional<FirmwareBlob> patchBlob;
+    results.push_back(Run(patchChecked ? "Patches::ApplyBuiltin" : "Patches::ApplyBuiltinUnchecked", iterations, 0,
+        [&]() { patchBlob = *Parse(image); },
+        [&]() {
+            if (patchChecked) {
+                Patches::ApplyBuiltin(*patchBlob);
+            } else {
+                Patches::ApplyBuiltinUnchecked(*patchBlob);
+            }
+        }));
+
+    // The whole flow DRXUtil runs for the built-in patches
+    results.push_back(Run("parse + patch + serialize", iterations, image.size(), none, [&]() {
+        auto blob = Parse(image);
+        if (patchChecked) {
+            Patches::ApplyBuiltin(*blob);
+        } else {
+            Patches::ApplyBuiltinUnchecked(*blob);
+        }
+
+        std::uint32_t crc = 0;
+        for (const auto& segment : blob->ToSegments()) {
+            crc = Utils::crc32(segment, crc);
+        }
+    }));
+
+    std::printf("%s, %zu bytes, %zu iterations%s\n\n", input.c_str(), image.size(), iterations,
+        AllocStats::ENABLED ? "" : " (built without ALLOC_STATS, allocations aren't counted)");
+    std::printf("%-36s %10s %10s %10s %10s %10s\n", "benchmark", "median ms", "min ms", "MB/s", "allocs", "alloc KiB");
+    for (const BenchResult& result : results) {
+        const std::string mbPerSec = result.mbPerSec ? Utils::sprintf("%.1f", *result.mbPerSec) : "n/a";
+        std::printf("%-36s %10.3f %10.3f %10s %10zu %10zu\n", result.name.c_str(), result.medianMs, result.minMs,
+            mbPerSec.c_str(), result.allocations.allocations, result.allocations.bytes / 1024);
+    }
+
+    if (!jsonPath.empty() && !WriteJSON(jsonPath, input, image.size(), results)) {
+        std::fprintf(stderr, "Failed to write '%s'\n", jsonPath.c_str());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Commands.hpp"
+#include "AllocStats.hpp"
+#include "Firmware.hpp"
+#include "PatchesTesting.hpp"
+#include "SyntheticFirmware.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <optional>
+
+namespace
+{
+
+// Allocation budgets of the DRXUtil firmware pipeline for the default synthetic image (seed 1, about 7 MiB).
+// Raise a budget only together with the change which needs more memory.
+struct Budget {
+    const char* name;
+    std::size_t maxAllocations;
+    std::size_t maxPeakBytes;
+};
+
+constexpr Budget kParseBudget    = { "FirmwareBlob::FromStream",       36, 15u << 20 };
+constexpr Budget kPatchBudget    = { "Patches::ApplyBuiltinUnchecked",  2,  1u << 10 };
+constexpr Budget kSegmentsBudget = { "FirmwareBlob::ToSegments",       20,  7u << 20 };
+constexpr Budget kToBytesBudget  = { "FirmwareBlob::ToBytes",           6,  8u << 20 };
+
+bool Check(const Budget& budget, const std::function<void()>& body)
+{
+    AllocStats::Counters counters;
+    {
+        AllocStats::Scope scope;
+        body();
+        counters = scope.Get();
+    }
+
+    const bool passed = counters.allocations <= budget.maxAllocations && counters.peakBytes <= budget.maxPeakBytes;
+    std::printf("%-32s %6zu / %-6zu allocs %10zu / %-10zu peak bytes  %s\n", budget.name,
+        counters.allocations, budget.maxAllocations, counters.peakBytes, budget.maxPeakBytes, passed ? "ok" : "OVER BUDGET");
+    return passed;
+}
+
+}
+
+int RunBudget(int argc, char** argv)
+{
+    if (argc > 1) {
+        std::printf("Usage: drxfw budget\n\n");
+        std::printf("Checks the allocation counts and peak heap usage of parsing, patching and serializing\n");
+        std::printf("a synthetic image against the budgets in BudgetCommand.cpp, fails if any is exceeded.\n");
+        return argc == 2 && std::string(argv[1]) == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (!AllocStats::ENABLED) {
+        std::fprintf(stderr, "drxfw was built without ALLOC_STATS, allocations can't be checked\n");
+        return EXIT_FAILURE;
+    }
+
+    auto image = GenerateSyntheticFirmware(SyntheticFirmwareConfig());
+    if (!image) {
+        std::fprintf(stderr, "Failed to generate image: %s\n", image.error().c_str());
+        return EXIT_FAILURE;
+    }
+
+    bool passed = true;
+    std::optional<FirmwareBlob> blob;
+    passed &= Check(kParseBudget, [&]() {
+        SpanStream stream(*image);
+        auto parsed = FirmwareBlob::FromStream(stream);
+        if (parsed) {
+            blob = std::move(*parsed);
+        }
+    });
+
+    if (!blob) {
+        std::fprintf(stderr, "Failed to parse the synthetic image\n");
+        return EXIT_FAILURE;
+    }
+
+    passed &= Check(kPatchBudget, [&]() {
+        Patches::ApplyBuiltinUnchecked(*blob);
+    });
+
+    passed &= Check(kSegmentsBudget, [&]() {
+        auto segments = blob->ToSegments();
+    });
+
+    passed &= Check(kToBytesBudget, [&]() {
+        auto bytes = blob->ToBytes();
+    });
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,292 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Commands.hpp"
+#include "FileUtils.hpp"
+#include "Firmware.hpp"
+#include "FirmwareDatabase.hpp"
+#include "Patches.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <utility>
+
+namespace
+{
+
+std::expected<FirmwareBlob, std::string> LoadBlob(const std::string& path, std::vector<std::byte>& data)
+{
+    if (!ReadFile(path, data)) {
+        return std::unexpected("Failed to read file");
+    }
+
+    SpanStream stream(data);
+    return FirmwareBlob::FromStream(stream);
+}
+
+std::string GetSectionName(const FirmwareSection& section)
+{
+    return std::string(section.GetName().begin(), section.GetName().end());
+}
+
+std::string GetOutputPath(const std::string& path, const CommandOptions& options)
+{
+    return (std::filesystem::path(options.outputDir) / std::filesystem::path(path).filename()).string();
+}
+
+CommandResult RunInfo(const std::string& path, const CommandOptions& options)
+{
+    // Only the headers are needed, so don't load and verify the whole image
+    FileStream stream(path);
+    if (stream.GetError() != Stream::ERROR_OK) {
+        return std::unexpected("Failed to open file");
+    }
+
+    auto info = FirmwareBlob::Peek(stream);
+    if (!info) {
+        return std::unexpected(info.error());
+    }
+
+    std::string report = Utils::sprintf("image version 0x%08x, block size 0x%x, sequence per session %u\n",
+        info->imageVersion, info->blockSize, info->sequencePerSession);
+    report += Utils::sprintf("  type 0x%08x, header CRC %s, super CRCs %s, %u pages\n", std::to_underlying(info->type),
+        info->headerCRCValid ? "valid" : "INVALID", info->superCRCsValid ? "valid" : "INVALID", unsigned(info->pageCRCs.size()));
+    for (const FirmwareSection::Header& section : info->sections) {
+        report += Utils::sprintf("  %.4s  version 0x%08x  offset 0x%08x  %8u bytes\n", section.name.data(),
+            section.version, section.offset, section.size);
+    }
+
+    report.pop_back();
+    return report;
+}
+
+CommandResult RunFingerprint(const std::string& path, const CommandOptions& options)
+{
+    FileStream stream(path);
+    if (stream.GetError() != Stream::ERROR_OK) {
+        return std::unexpected("Failed to open file");
+    }
+
+    auto info = FirmwareBlob::Peek(stream);
+    if (!info) {
+        return std::unexpected(info.error());
+    }
+
+    if (!info->headerCRCValid || !info->superCRCsValid) {
+        return std::unexpected("Invalid header CRCs");
+    }
+
+    const auto fingerprints = FirmwareDatabase::Fingerprint(info->sections, info->pageCRCs);
+    const FirmwareDatabase::Build* build = FirmwareDatabase::Identify(info->imageVersion, fingerprints);
+
+    // Print the fingerprints in the format of the database, so new builds can be added easily
+    std::string report = build ? Utils::sprintf("%s (%s)\n", build->name, build->region) : "unknown build\n";
+    report += Utils::sprintf("  image version 0x%08x\n", info->imageVersion);
+    for (const FirmwareDatabase::SectionFingerprint& fingerprint : fingerprints) {
+        report += Utils::sprintf("  { { '%c', '%c', '%c', '%c' }, 0x%08x },\n", fingerprint.name[0], fingerprint.name[1],
+            fingerprint.name[2], fingerprint.name[3], fingerprint.crc);
+    }
+
+    report.pop_back();
+    return report;
+}
+
+CommandResult RunVerify(const std::string& path, const CommandOptions& options)
+{
+    std::vector<std::byte> data;
+    auto blob = LoadBlob(path, data);
+    if (!blob) {
+        return std::unexpected(blob.error());
+    }
+
+    // Parsing already verified all CRCs, also make sure the image survives a round-trip unchanged
+    FirmwareSegments segments = blob->ToSegments();
+    if (segments.GetSize() != data.size()) {
+        return std::unexpected("Repacked image size differs");
+    }
+
+    std::size_t offset = 0;
+    for (const auto& segment : segments) {
+        if (!std::equal(segment.begin(), segment.end(), data.begin() + offset)) {
+            return std::unexpected(Utils::sprintf("Repacked image differs in segment at 0x%x", unsigned(offset)));
+        }
+        offset += segment.size();
+    }
+
+    return Utils::sprintf("OK, crc32 %08x", Utils::crc32(data));
+}
+
+CommandResult RunExtract(const std::string& path, const CommandOptions& options)
+{
+    std::vector<std::byte> data;
+    auto blob = LoadBlob(path, data);
+    if (!blob) {
+        return std::unexpected(blob.error());
+    }
+
+    const std::filesystem::path outputDir = std::filesystem::path(options.outputDir) / std::filesystem::path(path).stem();
+    std::error_code ec;
+    std::filesystem::create_directories(outputDir, ec);
+    if (ec) {
+        return std::unexpected("Failed to create " + outputDir.string());
+    }
+
+    std::size_t fileCount = 0;
+    for (const auto& section : blob->GetFirmware()) {
+        const std::string name = GetSectionName(*section);
+
+        FirmwareSegments segments;
+        section->SerializeSegments(segments);
+        if (!WriteSegments((outputDir / (name + ".bin")).string(), segments)) {
+            return std::unexpected("Failed to write section " + name);
+        }
+        fileCount++;
+
+        auto resources = std::dynamic_pointer_cast<ResourceSection>(section);
+        if (!resources) {
+            continue;
+        }
+
+        const std::filesystem::path resourceDir = outputDir / name;
+        std::filesystem::create_directories(resourceDir, ec);
+        if (ec) {
+            return std::unexpected("Failed to create " + resourceDir.string());
+        }
+
+        for (const Resource::Descriptor& descriptor : *resources) {
+            const std::string fileName = Utils::sprintf("%04x.bin", descriptor.id);
+            if (!WriteFile((resourceDir / fileName).string(), resources->GetResourceData(descriptor))) {
+                return std::unexpected("Failed to write resource " + fileName);
+            }
+            fileCount++;
+        }
+    }
+
+    return Utils::sprintf("extracted %u files to %s", unsigned(fileCount), outputDir.c_str());
+}
+
+CommandResult RunPatch(const std::string& path, const CommandOptions& options)
+{
+    std::vector<std::byte> data;
+    auto blob = LoadBlob(path, data);
+    if (!blob) {
+        return std::unexpected(blob.error());
+    }
+
+    auto patched = Patches::ApplyBuiltin(*blob);
+    if (!patched) {
+        return std::unexpected(patched.error());
+    }
+
+    FirmwareSegments segments = blob->ToSegments();
+    std::uint32_t crc = 0;
+    for (const auto& segment : segments) {
+        crc = Utils::crc32(segment, crc);
+    }
+
+    const bool known = Patches::IsKnownPatchedCRC(crc);
+    if (!known && !options.force) {
+        return std::unexpected(Utils::sprintf("Patched CRC %08x doesn't match, use --force to write anyway", crc));
+    }
+
+    const std::string outputPath = GetOutputPath(path, options);
+    if (!WriteSegments(outputPath, segments)) {
+        return std::unexpected("Failed to write " + outputPath);
+    }
+
+    return Utils::sprintf("patched, crc32 %08x%s -> %s", crc, known ? "" : " (unknown)", outputPath.c_str());
+}
+
+CommandResult RunRepack(const std::string& path, const CommandOptions& options)
+{
+    std::vector<std::byte> data;
+    auto blob = LoadBlob(path, data);
+    if (!blob) {
+        return std::unexpected(blob.error());
+    }
+
+    const std::string outputPath = GetOutputPath(path, options);
+    if (!WriteSegments(outputPath, blob->ToSegments())) {
+        return std::unexpected("Failed to write " + outputPath);
+    }
+
+    return "repacked -> " + outputPath;
+}
+
+}
+
+const FileCommand kFileCommands[] = {
+    { "info",        "Print image headers and sections without verifying the section data",   false, RunInfo },
+    { "fingerprint", "Identify the build from the header and print its section fingerprints", false, RunFingerprint },
+    { "verify",      "Verify all CRCs and check that the image repacks unchanged",            false, RunVerify },
+    { "extract",     "Extract sections and resources into <output>/<image name>/",            true,  RunExtract },
+    { "patch",       "Apply the built-in DRXUtil patches",                                    true,  RunPatch },
+    { "repack",      "Parse and serialize the image again",                                   true,  RunRepack },
+    { nullptr,       nullptr,                                                                 false, nullptr },
+};
+
+const FileCommand* FindFileCommand(const std::string& name)
+{
+    for (const FileCommand* command = kFileCommands; command->name; command++) {
+        if (name == command->name) {
+            return command;
+        }
+    }
+
+    return nullptr;
+}
+
+const ToolCommand kToolCommands[] = {
+    { "generate", "Generate synthetic firmware images, see 'generate --help'", RunGenerate },
+    { "bench",    "Benchmark the firmware pipeline, see 'bench --help'",      RunBench },
+    { "diff",     "Compare two images section by section",                   RunDiff },
+    { "simulate", "Run the flash and EEPROM flows on a simulated DRC",       RunSimulate },
+    { "budget",   "Check the allocation budgets of the firmware pipeline",   RunBudget },
+    { "sysinfo",  "Check the SystemInfo cache against a simulated DRC",      RunSystemInfo },
+    { "database", "Check the firmware database and build identification",    RunDatabase },
+    { nullptr,    nullptr,                                                    nullptr },
+};
+
+const ToolCommand* FindToolCommand(const std::string& name)
+{
+    for (const ToolCommand* command = kToolCommands; command->name; command++) {
+        if (name == command->name) {
+            return command;
+        }
+    }
+
+    return nullptr;
+}
+
+bool ParseSize(const char* str, std::size_t& size)
+{
+    char* end;
+    size = std::strtoull(str, &end, 0);
+    if (end == str) {
+        return false;
+    }
+
+    if (*end == 'K' || *end == 'k') {
+        size *= 1024;
+        end++;
+    } else if (*end == 'M' || *end == 'm') {
+        size *= 1024 * 1024;
+        end++;
+    }
+
+    return *end == '\0';
+}
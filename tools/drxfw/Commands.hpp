@@ -0,0 +1,66 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <expected>
+#include <string>
+
+struct CommandOptions {
+    // Directory output files are written to
+    std::string outputDir;
+    // Write patched images even if their CRC isn't a known one
+    bool force = false;
+};
+
+// Result of processing a single file, a human readable report or an error
+using CommandResult = std::expected<std::string, std::string>;
+
+// Commands which are run once per input file, possibly concurrently
+struct FileCommand {
+    const char* name;
+    const char* description;
+    bool needsOutputDir;
+    CommandResult (*run)(const std::string& path, const CommandOptions& options);
+};
+
+const FileCommand* FindFileCommand(const std::string& name);
+
+// All file commands, terminated by an entry with name set to nullptr
+extern const FileCommand kFileCommands[];
+
+// Commands which parse their own arguments
+struct ToolCommand {
+    const char* name;
+    const char* description;
+    int (*run)(int argc, char** argv);
+};
+
+const ToolCommand* FindToolCommand(const std::string& name);
+
+// All tool commands, terminated by an entry with name set to nullptr
+extern const ToolCommand kToolCommands[];
+
+int RunGenerate(int argc, char** argv);
+int RunBench(int argc, char** argv);
+int RunDiff(int argc, char** argv);
+int RunSimulate(int argc, char** argv);
+int RunBudget(int argc, char** argv);
+int RunSystemInfo(int argc, char** argv);
+int RunDatabase(int argc, char** argv);
+
+// Parse a size with an optional K or M suffix
+bool ParseSize(const char* str, std::size_t& size);
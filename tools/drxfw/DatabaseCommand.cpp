@@ -0,0 +1,106 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Commands.hpp"
+#include "Firmware.hpp"
+#include "FirmwareDatabase.hpp"
+#include "SyntheticFirmware.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+
+bool Expect(bool condition, const char* description)
+{
+    std::printf("%-56s %s\n", description, condition ? "ok" : "FAILED");
+    return condition;
+}
+
+std::expected<FirmwareBlob::PeekResult, std::string> PeekImage(const std::vector<std::byte>& image)
+{
+    SpanStream stream(image);
+    return FirmwareBlob::Peek(stream);
+}
+
+}
+
+int RunDatabase(int argc, char** argv)
+{
+    if (argc > 1) {
+        std::printf("Usage: drxfw database\n\n");
+        std::printf("Checks the entries of the firmware database and that Identify matches an image\n");
+        std::printf("by its section fingerprints, fails if a modified image is identified as well.\n");
+        return argc == 2 && std::string(argv[1]) == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    bool passed = true;
+    for (const FirmwareDatabase::Build& build : FirmwareDatabase::GetBuilds()) {
+        passed &= Expect(!build.sections.empty(), (std::string(build.name) + " has section fingerprints").c_str());
+    }
+
+    auto image = GenerateSyntheticFirmware(SyntheticFirmwareConfig());
+    if (!image) {
+        std::fprintf(stderr, "Failed to generate image: %s\n", image.error().c_str());
+        return EXIT_FAILURE;
+    }
+
+    auto info = PeekImage(*image);
+    if (!info) {
+        std::fprintf(stderr, "Failed to read the synthetic image: %s\n", info.error().c_str());
+        return EXIT_FAILURE;
+    }
+
+    // Register the synthetic image like a build from a real dump
+    const auto fingerprints = FirmwareDatabase::Fingerprint(info->sections, info->pageCRCs);
+    const FirmwareDatabase::Build builds[] = {
+        { "Synthetic", "none", info->imageVersion, fingerprints },
+    };
+    const FirmwareDatabase::Build emptyBuilds[] = {
+        { "Empty", "none", info->imageVersion, {} },
+    };
+
+    passed &= Expect(FirmwareDatabase::Identify(info->imageVersion, fingerprints, builds) == &builds[0],
+        "the fingerprinted image is identified");
+    passed &= Expect(!FirmwareDatabase::Identify(info->imageVersion + 1, fingerprints, builds),
+        "another image version isn't identified");
+    passed &= Expect(!FirmwareDatabase::Identify(info->imageVersion, fingerprints, emptyBuilds),
+        "builds without fingerprints never match");
+
+    // Change a single byte in LVC_, everything else including the version stays the same
+    SpanStream stream(*image);
+    auto blob = FirmwareBlob::FromStream(stream);
+    auto lvc = blob ? blob->GetFirmware().GetSection<GenericSection>("LVC_") : nullptr;
+    if (!lvc) {
+        std::fprintf(stderr, "Failed to parse the synthetic image\n");
+        return EXIT_FAILURE;
+    }
+
+    lvc->WriteAt<std::uint8_t>(0x100, std::to_integer<std::uint8_t>(~lvc->GetData()[0x100]));
+    auto modifiedInfo = PeekImage(blob->ToBytes());
+    if (!modifiedInfo) {
+        std::fprintf(stderr, "Failed to read the modified image: %s\n", modifiedInfo.error().c_str());
+        return EXIT_FAILURE;
+    }
+
+    const auto modifiedFingerprints = FirmwareDatabase::Fingerprint(modifiedInfo->sections, modifiedInfo->pageCRCs);
+    passed &= Expect(!FirmwareDatabase::Identify(modifiedInfo->imageVersion, modifiedFingerprints, builds),
+        "a modified image isn't identified");
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
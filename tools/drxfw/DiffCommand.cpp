@@ -0,0 +1,142 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Commands.hpp"
+#include "FileUtils.hpp"
+#include "FirmwareDiff.hpp"
+#include "Utils.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+
+// Limit the amount of ranges printed per section, unless printing everything was requested
+constexpr std::size_t MAX_PRINTED_RANGES = 32;
+
+const char* GetStatusName(FirmwareDiff::SectionDiff::Status status)
+{
+    switch (status) {
+    case FirmwareDiff::SectionDiff::Status::SAME:
+        return "same";
+    case FirmwareDiff::SectionDiff::Status::CHANGED:
+        return "changed";
+    case FirmwareDiff::SectionDiff::Status::ADDED:
+        return "added";
+    case FirmwareDiff::SectionDiff::Status::REMOVED:
+        return "removed";
+    }
+
+    return "";
+}
+
+const char* GetResourceChangeName(FirmwareDiff::ResourceChange::Kind kind)
+{
+    switch (kind) {
+    case FirmwareDiff::ResourceChange::Kind::ADDED:
+        return "added";
+    case FirmwareDiff::ResourceChange::Kind::REMOVED:
+        return "removed";
+    case FirmwareDiff::ResourceChange::Kind::CHANGED:
+        return "changed";
+    }
+
+    return "";
+}
+
+std::expected<FirmwareBlob, std::string> LoadBlob(const std::string& path)
+{
+    std::vector<std::byte> data;
+    if (!ReadFile(path, data)) {
+        return std::unexpected("Failed to read file");
+    }
+
+    SpanStream stream(data);
+    return FirmwareBlob::FromStream(stream);
+}
+
+}
+
+int RunDiff(int argc, char** argv)
+{
+    bool all = false;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--all") {
+            all = true;
+        } else if (!arg.starts_with("-")) {
+            paths.push_back(arg);
+        } else {
+            paths.clear();
+            break;
+        }
+    }
+
+    if (paths.size() != 2) {
+        std::printf("Usage: drxfw diff [--all] <old image> <new image>\n\n");
+        std::printf("  --all   Print all changed ranges instead of the first %zu per section\n", MAX_PRINTED_RANGES);
+        return EXIT_FAILURE;
+    }
+
+    auto oldBlob = LoadBlob(paths[0]);
+    if (!oldBlob) {
+        std::fprintf(stderr, "%s: %s\n", paths[0].c_str(), oldBlob.error().c_str());
+        return EXIT_FAILURE;
+    }
+
+    auto newBlob = LoadBlob(paths[1]);
+    if (!newBlob) {
+        std::fprintf(stderr, "%s: %s\n", paths[1].c_str(), newBlob.error().c_str());
+        return EXIT_FAILURE;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    FirmwareDiff diff = FirmwareDiff::Compare(oldBlob->GetFirmware(), newBlob->GetFirmware());
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (oldBlob->GetImageVersion() != newBlob->GetImageVersion()) {
+        std::printf("image version 0x%08x -> 0x%08x\n", oldBlob->GetImageVersion(), newBlob->GetImageVersion());
+    }
+
+    for (const FirmwareDiff::SectionDiff& section : diff.GetSections()) {
+        const std::string name(section.name.begin(), section.name.end());
+        std::printf("%s  %-7s  %u -> %u bytes", name.c_str(), GetStatusName(section.status),
+            unsigned(section.oldSize), unsigned(section.newSize));
+        if (section.status == FirmwareDiff::SectionDiff::Status::CHANGED) {
+            std::printf(", %zu changed ranges", section.ranges.size());
+        }
+        std::printf("\n");
+
+        for (std::size_t i = 0; i < section.ranges.size(); i++) {
+            if (!all && i == MAX_PRINTED_RANGES) {
+                std::printf("    ... %zu more\n", section.ranges.size() - i);
+                break;
+            }
+
+            std::printf("    0x%08zx  %zu bytes\n", section.ranges[i].offset, section.ranges[i].size);
+        }
+
+        for (const FirmwareDiff::ResourceChange& change : section.resources) {
+            std::printf("    resource 0x%04x %s\n", change.id, GetResourceChangeName(change.kind));
+        }
+    }
+
+    std::printf("%zu pages skipped, %zu pages compared, %.2f ms\n", diff.GetSkippedPages(), diff.GetComparedPages(), ms);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,97 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "FileUtils.hpp"
+#include <algorithm>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+bool ReadFile(const std::string& path, std::vector<std::byte>& data)
+{
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) {
+        return false;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(f);
+        return false;
+    }
+
+    data.resize(size);
+    if (fread(data.data(), 1, data.size(), f) != data.size()) {
+        fclose(f);
+        return false;
+    }
+
+    fclose(f);
+    return true;
+}
+
+bool WriteFile(const std::string& path, std::span<const std::byte> data)
+{
+    FirmwareSegments segments;
+    segments.Append(data);
+    return WriteSegments(path, segments);
+}
+
+bool WriteSegments(const std::string& path, const FirmwareSegments& segments)
+{
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    std::vector<iovec> iov;
+    iov.reserve(segments.GetSegments().size());
+    for (const auto& segment : segments) {
+        if (!segment.empty()) {
+            iov.push_back(iovec{const_cast<std::byte*>(segment.data()), segment.size()});
+        }
+    }
+
+    // writev takes at most IOV_MAX segments and may write less than requested
+    std::size_t first = 0;
+    while (first < iov.size()) {
+        const int count = std::min<std::size_t>(iov.size() - first, IOV_MAX);
+        ssize_t written = writev(fd, &iov[first], count);
+        if (written < 0) {
+            close(fd);
+            return false;
+        }
+
+        while (written > 0) {
+            iovec& vec = iov[first];
+            if (std::size_t(written) >= vec.iov_len) {
+                written -= vec.iov_len;
+                first++;
+            } else {
+                vec.iov_base = static_cast<std::byte*>(vec.iov_base) + written;
+                vec.iov_len -= written;
+                written = 0;
+            }
+        }
+    }
+
+    return close(fd) == 0;
+}
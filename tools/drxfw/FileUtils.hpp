@@ -0,0 +1,31 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "Firmware.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Read a whole file into memory
+bool ReadFile(const std::string& path, std::vector<std::byte>& data);
+
+// Write data to a file, replacing it if it exists
+bool WriteFile(const std::string& path, std::span<const std::byte> data);
+
+// Write all segments to a file with as few system calls as possible
+bool WriteSegments(const std::string& path, const FirmwareSegments& segments);
@@ -0,0 +1,138 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Commands.hpp"
+#include "FileUtils.hpp"
+#include "SyntheticFirmware.hpp"
+#include "JobSystem.hpp"
+#include "Utils.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+
+namespace
+{
+
+void PrintGenerateUsage()
+{
+    std::printf("Usage: drxfw generate -o <output dir> [options]\n\n");
+    std::printf("Options:\n");
+    std::printf("  --seed <n>           Seed of the first image (default 1)\n");
+    std::printf("  --count <n>          Number of images, seeds are incremented for each image (default 1)\n");
+    std::printf("  --sections <n>       Number of generic sections (default 2)\n");
+    std::printf("  --section-size <n>   Average generic section size, K and M suffixes are allowed (default 512K)\n");
+    std::printf("  --resources <n>      Number of IMG_ resources (default 64)\n");
+    std::printf("  --bitmap <w>x<h>     Largest bitmap dimensions (default 854x480)\n");
+    std::printf("  --size <n>           Size the generic sections to get images of roughly this size\n");
+    std::printf("  -j <jobs>            Number of images generated concurrently\n");
+}
+
+}
+
+int RunGenerate(int argc, char** argv)
+{
+    SyntheticFirmwareConfig config;
+    std::string outputDir;
+    std::size_t count = 1;
+    std::size_t jobs = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        std::size_t number = 0;
+        bool valid = value != nullptr;
+
+        if (arg == "--help") {
+            PrintGenerateUsage();
+            return EXIT_SUCCESS;
+        } else if (arg == "-o" && valid) {
+            outputDir = value;
+        } else if (arg == "--seed" && valid) {
+            config.seed = std::strtoull(value, nullptr, 0);
+        } else if (arg == "--count" && valid && (valid = ParseSize(value, number))) {
+            count = number;
+        } else if (arg == "--sections" && valid && (valid = ParseSize(value, number))) {
+            config.genericSectionCount = number;
+        } else if (arg == "--section-size" && valid && (valid = ParseSize(value, number))) {
+            config.genericSectionSize = number;
+        } else if (arg == "--resources" && valid && (valid = ParseSize(value, number))) {
+            config.resourceCount = number;
+        } else if (arg == "--bitmap" && valid) {
+            valid = std::sscanf(value, "%ux%u", &config.bitmapWidth, &config.bitmapHeight) == 2;
+        } else if (arg == "--size" && valid && (valid = ParseSize(value, number))) {
+            config.targetSize = number;
+        } else if (arg == "-j" && valid && (valid = ParseSize(value, number))) {
+            jobs = number;
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            std::fprintf(stderr, "Invalid argument '%s'\n\n", arg.c_str());
+            PrintGenerateUsage();
+            return EXIT_FAILURE;
+        }
+        i++;
+    }
+
+    if (outputDir.empty()) {
+        std::fprintf(stderr, "'generate' requires an output directory (-o)\n");
+        return EXIT_FAILURE;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(outputDir, ec);
+    if (ec) {
+        std::fprintf(stderr, "Failed to create '%s'\n", outputDir.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::mutex printMutex;
+    std::size_t failed = 0;
+    {
+        JobSystem jobSystem(std::min<std::size_t>(jobs, count));
+        for (std::size_t i = 0; i < count; i++) {
+            SyntheticFirmwareConfig imageConfig = config;
+            imageConfig.seed = config.seed + i;
+
+            jobSystem.Submit([&, imageConfig]() {
+                const auto start = std::chrono::steady_clock::now();
+                auto image = GenerateSyntheticFirmware(imageConfig);
+                const std::string path = (std::filesystem::path(outputDir) /
+                    Utils::sprintf("synthetic_%llu.bin", (unsigned long long) imageConfig.seed)).string();
+                const bool written = image && WriteFile(path, *image);
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                std::lock_guard lock(printMutex);
+                if (!image) {
+                    std::printf("%s: error: %s\n", path.c_str(), image.error().c_str());
+                    failed++;
+                } else if (!written) {
+                    std::printf("%s: error: Failed to write file\n", path.c_str());
+                    failed++;
+                } else {
+                    std::printf("%s: %zu bytes, %.1f ms\n", path.c_str(), image->size(), seconds * 1000.0);
+                }
+            });
+        }
+        jobSystem.Wait();
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
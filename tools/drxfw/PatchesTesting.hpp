@@ -0,0 +1,29 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "Firmware.hpp"
+
+// Test only entry points of Patches, for running the patches on synthetic images.
+// Not part of Patches.hpp, so DRXUtil can't skip the checks of ApplyBuiltin.
+namespace Patches
+{
+
+// Apply the built-in patches without checking the firmware first
+void ApplyBuiltinUnchecked(FirmwareBlob& blob);
+
+}
@@ -0,0 +1,201 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Commands.hpp"
+#include "DRC.hpp"
+#include "PlatformSimulator.hpp"
+#include "Utils.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+
+void PrintSimulateUsage()
+{
+    std::printf("Usage: drxfw simulate [options] flash <image>\n");
+    std::printf("       drxfw simulate [options] region <value>\n");
+    std::printf("       drxfw simulate [options] deviceinfo <value>\n\n");
+    std::printf("Runs the flash or EEPROM flow of DRXUtil against a simulated DRC and reports the simulated time.\n");
+    std::printf("The EEPROM flows expect the patched firmware, so the simulated DRC starts out running it.\n\n");
+    std::printf("Options:\n");
+    std::printf("  --latency <ms>     Duration of every request (default %u)\n", unsigned(SimulatedPlatform::Config().requestLatencyMs));
+    std::printf("  --reattach <ms>    Time the DRC needs to reattach (default %u)\n", unsigned(SimulatedPlatform::Config().reattachMs));
+    std::printf("  --eeprom <ms>      Time until the EEPROM is available after a reattach (default %u)\n", unsigned(SimulatedPlatform::Config().eepromDelayMs));
+    std::printf("  --update <ms>      Time to flash an image (default %u)\n", unsigned(SimulatedPlatform::Config().updateMs));
+    std::printf("  --poll <ms>        Interval of the update progress queries (default %u)\n", unsigned(DRC::DEFAULT_PROGRESS_POLL_INTERVAL_MS));
+    std::printf("  --fail <step>      Let reattach, update or activate fail\n");
+}
+
+class Simulation {
+public:
+    Simulation(SimulatedPlatform& platform) : mPlatform(platform) {}
+
+    void Step(const char* name)
+    {
+        std::printf("[%8llu ms] %s\n", static_cast<unsigned long long>(mPlatform.GetTimeMs()), name);
+    }
+
+    bool Fail(const char* error)
+    {
+        std::printf("[%8llu ms] error: %s\n", static_cast<unsigned long long>(mPlatform.GetTimeMs()), error);
+        return false;
+    }
+
+    SimulatedPlatform& GetPlatform() { return mPlatform; }
+
+private:
+    SimulatedPlatform& mPlatform;
+};
+
+const char* GetStageName(DRC::FlashStage stage)
+{
+    switch (stage) {
+        case DRC::FlashStage::PREPARE:
+            return "reattach in update mode";
+        case DRC::FlashStage::FLASH:
+            return "flashing";
+        case DRC::FlashStage::ACTIVATE:
+            return "activate and reattach in active mode";
+    }
+
+    return "unknown stage";
+}
+
+// Runs DRC::Flash, which FlashScreen uses as well
+bool SimulateFlash(Simulation& sim, const std::string& path, std::uint32_t pollIntervalMs)
+{
+    SimulatedPlatform& platform = sim.GetPlatform();
+
+    std::int32_t lastProgress = -1;
+    DRC::FlashHooks hooks;
+    hooks.pollIntervalMs = pollIntervalMs;
+    hooks.onStage = [&sim](DRC::FlashStage stage) { sim.Step(GetStageName(stage)); };
+    hooks.onProgress = [&sim, &lastProgress](std::int32_t progress) {
+        if (progress / 25 != lastProgress / 25) {
+            sim.Step(("flashing " + std::to_string(progress) + "%").c_str());
+            lastProgress = progress;
+        }
+    };
+
+    auto result = DRC::Flash(platform, path, hooks);
+    if (!result) {
+        return sim.Fail(result.error().c_str());
+    }
+
+    Platform::SoftwareVersion version{};
+    platform.GetSoftwareVersion(Platform::Destination::DRC0, version);
+    sim.Step(("done, running version 0x" + Utils::sprintf("%08x", version.runningVersion)).c_str());
+    return true;
+}
+
+// Runs DRC::SetEepromValue, which SetRegionScreen and EditDeviceInfoScreen use as well
+bool SimulateSetEepromValue(Simulation& sim, std::uint8_t configId, std::uint32_t offset, std::uint8_t value)
+{
+    sim.Step(Utils::sprintf("write 0x%02x", value).c_str());
+    if (!DRC::SetEepromValue(sim.GetPlatform(), configId, offset, value)) {
+        return sim.Fail("Failed to write value.");
+    }
+
+    sim.Step("done");
+    return true;
+}
+
+}
+
+int RunSimulate(int argc, char** argv)
+{
+    SimulatedPlatform::Config config;
+    std::string flow;
+    std::string argument;
+    std::uint32_t pollIntervalMs = DRC::DEFAULT_PROGRESS_POLL_INTERVAL_MS;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--help") {
+            PrintSimulateUsage();
+            return EXIT_SUCCESS;
+        } else if (arg == "--latency" && hasValue) {
+            config.requestLatencyMs = std::strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--reattach" && hasValue) {
+            config.reattachMs = std::strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--eeprom" && hasValue) {
+            config.eepromDelayMs = std::strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--update" && hasValue) {
+            config.updateMs = std::strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--poll" && hasValue) {
+            pollIntervalMs = std::strtoul(argv[++i], nullptr, 0);
+            if (pollIntervalMs == 0) {
+                std::fprintf(stderr, "The poll interval must not be 0\n");
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--fail" && hasValue) {
+            const std::string step = argv[++i];
+            if (step == "reattach") {
+                config.failReattach = true;
+            } else if (step == "update") {
+                config.failUpdate = true;
+            } else if (step == "activate") {
+                config.failActivate = true;
+            } else {
+                std::fprintf(stderr, "Unknown step '%s'\n", step.c_str());
+                return EXIT_FAILURE;
+            }
+        } else if (!arg.starts_with("-") && flow.empty()) {
+            flow = arg;
+        } else if (!arg.starts_with("-") && argument.empty()) {
+            argument = arg;
+        } else {
+            std::fprintf(stderr, "Invalid argument '%s'\n\n", arg.c_str());
+            PrintSimulateUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (flow.empty() || argument.empty()) {
+        PrintSimulateUsage();
+        return EXIT_FAILURE;
+    }
+
+    if (flow == "region" || flow == "deviceinfo") {
+        config.drcVersion = config.patchedVersion;
+    }
+
+    SimulatedPlatform platform(config);
+    Simulation sim(platform);
+
+    bool success;
+    if (flow == "flash") {
+        success = SimulateFlash(sim, argument, pollIntervalMs);
+    } else if (flow == "region") {
+        success = SimulateSetEepromValue(sim, DRC::UIC_CONFIG_REGION, DRC::EEPROM_REGION, std::strtoul(argument.c_str(), nullptr, 0));
+    } else if (flow == "deviceinfo") {
+        success = SimulateSetEepromValue(sim, DRC::UIC_CONFIG_DEVICE_INFO, DRC::EEPROM_DEVICE_INFO, std::strtoul(argument.c_str(), nullptr, 0));
+    } else {
+        std::fprintf(stderr, "Unknown flow '%s'\n\n", flow.c_str());
+        PrintSimulateUsage();
+        return EXIT_FAILURE;
+    }
+
+    SimulatedPlatform::Stats stats = platform.GetStats();
+    std::printf("%s: %s, %llu ms simulated, %u DRC requests, %u EEPROM requests, %u system requests\n",
+        flow.c_str(), success ? "ok" : "failed", static_cast<unsigned long long>(platform.GetTimeMs()),
+        unsigned(stats.drcRequests), unsigned(stats.eepromRequests), unsigned(stats.systemRequests));
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
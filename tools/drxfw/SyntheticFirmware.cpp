@@ -0,0 +1,239 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "SyntheticFirmware.hpp"
+#include "Firmware.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+namespace
+{
+
+constexpr std::uint32_t SECTION_VERSION = 7;
+constexpr std::uint32_t STARTUP_SCREEN_ID = 0x2001;
+
+// Only use raw engine output, distributions aren't guaranteed to be identical across standard libraries
+class Random {
+public:
+    Random(std::uint64_t seed) : mEngine(seed) {}
+
+    std::uint32_t Range(std::uint32_t min, std::uint32_t max) { return min + mEngine() % (std::uint64_t(max) - min + 1); }
+
+    void Fill(std::span<std::byte> out)
+    {
+        std::size_t i = 0;
+        for (; i + 8 <= out.size(); i += 8) {
+            const std::uint64_t value = mEngine();
+            std::memcpy(out.data() + i, &value, 8);
+        }
+
+        if (i < out.size()) {
+            const std::uint64_t value = mEngine();
+            std::memcpy(out.data() + i, &value, out.size() - i);
+        }
+    }
+
+private:
+    std::mt19937_64 mEngine;
+};
+
+struct Section {
+    std::array<char, 4> name;
+    std::vector<std::byte> data;
+};
+
+std::vector<std::byte> GenerateBitmap(Random& random, std::uint32_t width, std::uint32_t height)
+{
+    std::vector<std::byte> data(BitmapResource::PALETTE_SIZE + width * height);
+
+    // Like the real palettes, the last entries are unused and all zero
+    random.Fill(std::span(data).first(BitmapResource::PALETTE_SIZE - 16 * sizeof(std::uint32_t)));
+
+    // Horizontal runs of the same index, similar to actual images
+    std::span<std::byte> pixels = std::span(data).subspan(BitmapResource::PALETTE_SIZE);
+    for (std::size_t i = 0; i < pixels.size();) {
+        const std::size_t length = std::min<std::size_t>(random.Range(1, 64), pixels.size() - i);
+        std::fill_n(pixels.begin() + i, length, std::byte(random.Range(0, 239)));
+        i += length;
+    }
+
+    return data;
+}
+
+std::vector<std::byte> GenerateResourceSection(Random& random, const SyntheticFirmwareConfig& config)
+{
+    struct Entry {
+        Resource::Type type;
+        std::uint16_t id;
+        std::array<std::byte, 12> parameters;
+        std::vector<std::byte> data;
+    };
+
+    std::vector<Entry> entries;
+    for (std::uint32_t i = 0; i < config.resourceCount; i++) {
+        Entry entry{};
+        MutableSpanStream parameters(entry.parameters, std::endian::little);
+        const std::uint32_t kind = i == 0 ? 0 : random.Range(0, 9);
+        if (kind < 7) {
+            // The first resource is always the full size startup screen
+            const std::uint32_t width = i == 0 ? config.bitmapWidth : random.Range(1, std::max(1u, config.bitmapWidth));
+            const std::uint32_t height = i == 0 ? config.bitmapHeight : random.Range(1, std::max(1u, config.bitmapHeight));
+            entry.type = Resource::Type::BITMAP;
+            entry.id = i == 0 ? STARTUP_SCREEN_ID : 0x2000 + i + 1;
+            parameters << std::uint32_t(1) << width << height;
+            entry.data = GenerateBitmap(random, width, height);
+        } else if (kind < 9) {
+            entry.type = Resource::Type::SOUND;
+            entry.id = 0x3000 + i;
+            parameters << std::uint16_t(1) << std::uint16_t(16) << std::uint32_t(random.Range(1, 2)) << std::uint32_t(48000);
+            entry.data.resize(random.Range(0x400, 0x10000) & ~3u);
+            random.Fill(entry.data);
+        } else {
+            entry.type = Resource::Type::UNKNOWN;
+            entry.id = 0x4000 + i;
+            random.Fill(entry.parameters);
+            entry.data.resize(random.Range(0, 0x1000));
+            random.Fill(entry.data);
+        }
+
+        entries.push_back(std::move(entry));
+    }
+
+    std::size_t dataSize = 0;
+    for (const Entry& entry : entries) {
+        dataSize += entry.data.size();
+    }
+
+    std::vector<std::byte> bytes(sizeof(std::uint32_t) + entries.size() * Resource::DESCRIPTOR_SIZE + dataSize);
+    MutableSpanStream stream(bytes, std::endian::little);
+    stream << std::uint32_t(entries.size());
+
+    std::uint32_t offset = 0;
+    for (const Entry& entry : entries) {
+        stream << entry.type << entry.id << offset << std::uint32_t(entry.data.size()) << entry.parameters;
+        offset += entry.data.size();
+    }
+
+    for (const Entry& entry : entries) {
+        stream.Write(entry.data);
+    }
+
+    return bytes;
+}
+
+}
+
+std::expected<std::vector<std::byte>, std::string> GenerateSyntheticFirmware(const SyntheticFirmwareConfig& config)
+{
+    if (config.resourceCount > 0xfff) {
+        return std::unexpected("Too many resources");
+    }
+
+    Random random(config.seed);
+
+    std::vector<Section> sections;
+    sections.push_back(Section{{'I', 'M', 'G', '_'}, GenerateResourceSection(random, config)});
+
+    std::vector<std::byte> version(0x10);
+    MutableSpanStream versionStream(version, std::endian::little);
+    versionStream << config.imageVersion;
+    sections.push_back(Section{{'V', 'E', 'R', '_'}, std::move(version)});
+
+    // Size the generic sections to reach the target size, if there is one
+    std::size_t genericSectionSize = config.genericSectionSize;
+    if (config.targetSize && config.genericSectionCount) {
+        std::size_t fixedSize = FirmwareBlob::HEADER_SIZE + Firmware::HEADER_SIZE + Firmware::SUB_CRC_TABLE_SIZE +
+                                (sections.size() + config.genericSectionCount + 1) * FirmwareSection::Header::SIZE;
+        for (const Section& section : sections) {
+            fixedSize += section.data.size();
+        }
+
+        if (fixedSize >= config.targetSize) {
+            return std::unexpected("Target size is too small for the requested resources");
+        }
+
+        genericSectionSize = (config.targetSize - fixedSize) / config.genericSectionCount;
+    }
+
+    for (std::uint32_t i = 0; i < config.genericSectionCount; i++) {
+        std::array<char, 4> name = {'L', 'V', 'C', '_'};
+        if (i != 0) {
+            const std::string generated = Utils::sprintf("S%03u", i);
+            std::copy_n(generated.begin(), 4, name.begin());
+        }
+
+        // Vary sizes a bit, unless the image needs to hit a target size
+        std::size_t size = genericSectionSize;
+        if (!config.targetSize) {
+            size = size * random.Range(75, 125) / 100;
+        }
+
+        std::vector<std::byte> data(size);
+        random.Fill(data);
+        // Keep LVC_ right after INDX like in real images
+        sections.insert(i == 0 ? sections.begin() : sections.end(), Section{name, std::move(data)});
+    }
+
+    // INDX followed by the section data
+    const std::size_t indxSize = (sections.size() + 1) * FirmwareSection::Header::SIZE;
+    std::size_t payloadSize = indxSize;
+    for (const Section& section : sections) {
+        payloadSize += section.data.size();
+    }
+
+    // Every page needs a sub-CRC
+    if (payloadSize > (Firmware::SUB_CRC_TABLE_SIZE / sizeof(std::uint32_t)) * Firmware::PAGE_SIZE) {
+        return std::unexpected("Image is too large for the sub-CRC table");
+    }
+
+    const std::size_t imageSize = Firmware::HEADER_SIZE + Firmware::SUB_CRC_TABLE_SIZE + payloadSize;
+    std::vector<std::byte> blob(FirmwareBlob::HEADER_SIZE + imageSize);
+
+    MutableSpanStream blobHeader{std::span(blob).first(FirmwareBlob::HEADER_SIZE), std::endian::big};
+    blobHeader << config.imageVersion << std::uint32_t(0x1000) << std::uint32_t(0x20) << std::uint32_t(imageSize);
+
+    std::span<std::byte> image = std::span(blob).subspan(FirmwareBlob::HEADER_SIZE);
+    std::span<std::byte> header = image.first(Firmware::HEADER_SIZE);
+    std::span<std::byte> subCRCData = image.subspan(Firmware::HEADER_SIZE, Firmware::SUB_CRC_TABLE_SIZE);
+    std::span<std::byte> payload = image.subspan(Firmware::HEADER_SIZE + Firmware::SUB_CRC_TABLE_SIZE);
+
+    MutableSpanStream indx(payload.first(indxSize), std::endian::little);
+    indx << std::uint32_t(0) << std::uint32_t(indxSize) << std::array<char, 4>{'I', 'N', 'D', 'X'} << std::uint32_t(1);
+    std::size_t offset = indxSize;
+    for (const Section& section : sections) {
+        indx << std::uint32_t(offset) << std::uint32_t(section.data.size()) << section.name << SECTION_VERSION;
+        std::copy(section.data.begin(), section.data.end(), payload.begin() + offset);
+        offset += section.data.size();
+    }
+
+    MutableSpanStream subCRCs(subCRCData, std::endian::little);
+    for (std::size_t i = 0; i < payload.size(); i += Firmware::PAGE_SIZE) {
+        subCRCs << Utils::crc32(payload.subspan(i, std::min(Firmware::PAGE_SIZE, payload.size() - i)));
+    }
+
+    MutableSpanStream headerStream(header, std::endian::little);
+    headerStream << Firmware::Type::DRC;
+    for (std::size_t i = 0; i < 4; i++) {
+        headerStream << Utils::crc32(subCRCData.subspan(i * 0x1000, 0x1000));
+    }
+    headerStream.SetPosition(Firmware::HEADER_SIZE - sizeof(std::uint32_t));
+    headerStream << Utils::crc32(header.first(Firmware::HEADER_SIZE - sizeof(std::uint32_t)));
+
+    return blob;
+}
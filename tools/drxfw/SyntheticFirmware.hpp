@@ -0,0 +1,44 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <vector>
+
+// Parameters for generating structurally valid firmware images without real firmware data
+struct SyntheticFirmwareConfig {
+    // Same seed and parameters always generate the same image
+    std::uint64_t seed = 1;
+    std::uint32_t imageVersion = 0x190c0117;
+    // Number of generic sections besides INDX, IMG_ and VER_, the first one is called LVC_
+    std::uint32_t genericSectionCount = 2;
+    // Average generic section size, the actual sizes vary by up to 25%
+    std::uint32_t genericSectionSize = 0x80000;
+    // Number of resources in the IMG_ section
+    std::uint32_t resourceCount = 64;
+    // Largest bitmap dimensions, the startup screen bitmap (0x2001) always uses these
+    std::uint32_t bitmapWidth = 854;
+    std::uint32_t bitmapHeight = 480;
+    // If not 0, the generic section sizes are chosen so the image is roughly this large
+    std::size_t targetSize = 0;
+};
+
+// Generate a complete drc_fw.bin style image with correct INDX, sub-CRCs, super CRCs and header CRC
+std::expected<std::vector<std::byte>, std::string> GenerateSyntheticFirmware(const SyntheticFirmwareConfig& config);
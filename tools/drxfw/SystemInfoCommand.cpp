@@ -0,0 +1,86 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Commands.hpp"
+#include "PlatformSimulator.hpp"
+#include "SystemInfo.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+
+std::uint32_t CountRequests(SimulatedPlatform& platform)
+{
+    SimulatedPlatform::Stats stats = platform.GetStats();
+    return stats.systemRequests + stats.drcRequests + stats.eepromRequests;
+}
+
+bool Expect(bool condition, const char* description)
+{
+    std::printf("%-56s %s\n", description, condition ? "ok" : "FAILED");
+    return condition;
+}
+
+}
+
+int RunSystemInfo(int argc, char** argv)
+{
+    if (argc > 1) {
+        std::printf("Usage: drxfw sysinfo\n\n");
+        std::printf("Checks that SystemInfo only queries the simulated DRC when nothing usable is cached,\n");
+        std::printf("fails if a cached value causes requests or Invalidate doesn't cause a new query.\n");
+        return argc == 2 && std::string(argv[1]) == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // SystemInfo always uses the default platform, which is simulated on the host
+    SimulatedPlatform& platform = static_cast<SimulatedPlatform&>(Platform::GetDefault());
+    bool passed = true;
+
+    // Right after a reattach the DRC answers, but the cached EEPROM wasn't read yet
+    platform.InitReattach();
+    platform.SetDRCState(Platform::DRCState::ACTIVE);
+    platform.WaitReattach();
+
+    SystemInfo::DRCInfo info = SystemInfo::GetDRCInfo();
+    passed &= Expect(info.drcVersion && !info.region, "versions are available before the EEPROM");
+
+    std::uint32_t requests = CountRequests(platform);
+    SystemInfo::GetDRCInfo();
+    passed &= Expect(CountRequests(platform) != requests, "incomplete results aren't cached");
+
+    platform.SleepMs(SimulatedPlatform::Config().eepromDelayMs);
+    info = SystemInfo::GetDRCInfo();
+    passed &= Expect(info.drcVersion && info.boardInfo && info.region && info.deviceInfo, "everything is available once the EEPROM was read");
+
+    requests = CountRequests(platform);
+    SystemInfo::GetDRCInfo();
+    passed &= Expect(CountRequests(platform) == requests, "a second GetDRCInfo doesn't make any requests");
+
+    SystemInfo::Invalidate();
+    SystemInfo::GetDRCInfo();
+    passed &= Expect(CountRequests(platform) != requests, "Invalidate queries the DRC again");
+
+    std::string path;
+    SystemInfo::GetDRCFirmwarePath(path);
+    requests = CountRequests(platform);
+    SystemInfo::GetDRCFirmwarePath(path);
+    passed &= Expect(CountRequests(platform) == requests, "the firmware path is cached as well");
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,148 @@
+/*
+ *   Copyright (C) 2025 GaryOderNichts
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Commands.hpp"
+#include "JobSystem.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+void PrintUsage(const char* argv0)
+{
+    std::printf("Usage: %s <command> [-j <jobs>] [-o <output dir>] [--force] <files...>\n\n", argv0);
+    std::printf("Commands:\n");
+    for (const FileCommand* command = kFileCommands; command->name; command++) {
+        std::printf("  %-12s %s\n", command->name, command->description);
+    }
+    for (const ToolCommand* command = kToolCommands; command->name; command++) {
+        std::printf("  %-12s %s\n", command->name, command->description);
+    }
+    std::printf("\nOptions:\n");
+    std::printf("  -j <jobs>    Number of files processed concurrently, defaults to the number of CPUs\n");
+    std::printf("  -o <dir>     Output directory, required by extract, patch and repack\n");
+    std::printf("  --force      Write patched images even if their CRC is unknown\n");
+}
+
+int RunFileCommand(const FileCommand& command, const CommandOptions& options, const std::vector<std::string>& files, std::size_t jobs)
+{
+    std::mutex printMutex;
+    std::size_t failed = 0;
+    std::uintmax_t totalBytes = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        JobSystem jobSystem(std::min(jobs, files.size()));
+        for (const std::string& file : files) {
+            jobSystem.Submit([&, file]() {
+                std::error_code ec;
+                const std::uintmax_t size = std::filesystem::file_size(file, ec);
+
+                const auto fileStart = std::chrono::steady_clock::now();
+                CommandResult result = command.run(file, options);
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - fileStart).count();
+
+                std::lock_guard lock(printMutex);
+                if (result) {
+                    std::printf("%s: %s\n", file.c_str(), result->c_str());
+                } else {
+                    std::printf("%s: error: %s\n", file.c_str(), result.error().c_str());
+                    failed++;
+                }
+                std::printf("%s: %.1f ms, %.1f MB/s\n", file.c_str(), seconds * 1000.0, ec ? 0.0 : size / seconds / 1e6);
+                totalBytes += ec ? 0 : size;
+            });
+        }
+        jobSystem.Wait();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%zu files, %zu failed, %.1f ms, %.1f MB/s\n", files.size(), failed, seconds * 1000.0, totalBytes / seconds / 1e6);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (const ToolCommand* toolCommand = FindToolCommand(argv[1])) {
+        return toolCommand->run(argc - 1, argv + 1);
+    }
+
+    const FileCommand* command = FindFileCommand(argv[1]);
+    if (!command) {
+        std::fprintf(stderr, "Unknown command '%s'\n\n", argv[1]);
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    CommandOptions options;
+    std::size_t jobs = 0;
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            jobs = std::strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "-o" && i + 1 < argc) {
+            options.outputDir = argv[++i];
+        } else if (arg == "--force") {
+            options.force = true;
+        } else if (arg.starts_with("-")) {
+            std::fprintf(stderr, "Unknown option '%s'\n", arg.c_str());
+            return EXIT_FAILURE;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty()) {
+        std::fprintf(stderr, "No input files\n");
+        return EXIT_FAILURE;
+    }
+
+    if (command->needsOutputDir) {
+        if (options.outputDir.empty()) {
+            std::fprintf(stderr, "'%s' requires an output directory (-o)\n", command->name);
+            return EXIT_FAILURE;
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(options.outputDir, ec);
+        if (ec) {
+            std::fprintf(stderr, "Failed to create '%s'\n", options.outputDir.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (jobs == 0) {
+        jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    return RunFileCommand(*command, options, files, jobs);
+}
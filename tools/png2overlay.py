@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+#
+#   Copyright (C) 2025 GaryOderNichts
+#
+#   This program is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 2 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+# Converts a PNG into a BitmapOverlay header which can be blended onto a BitmapResource.
+# Pixels are considered set if they're opaque (alpha >= 128), or bright (luminance >= 128) for images without alpha.
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+PNG_SIGNATURE = b'\x89PNG\r\n\x1a\n'
+
+# channels per color type
+CHANNELS = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    if pb <= pc:
+        return b
+    return c
+
+def unfilter(data, width, height, bpp, stride):
+    rows = []
+    prev = bytearray(stride)
+    pos = 0
+    for _ in range(height):
+        filter_type = data[pos]
+        row = bytearray(data[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        for i in range(stride):
+            a = row[i - bpp] if i >= bpp else 0
+            b = prev[i]
+            c = prev[i - bpp] if i >= bpp else 0
+            if filter_type == 1:
+                row[i] = (row[i] + a) & 0xff
+            elif filter_type == 2:
+                row[i] = (row[i] + b) & 0xff
+            elif filter_type == 3:
+                row[i] = (row[i] + ((a + b) >> 1)) & 0xff
+            elif filter_type == 4:
+                row[i] = (row[i] + paeth(a, b, c)) & 0xff
+            elif filter_type != 0:
+                raise ValueError('invalid filter type %d' % filter_type)
+        rows.append(row)
+        prev = row
+    return rows
+
+def read_png(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    if data[:8] != PNG_SIGNATURE:
+        raise ValueError('not a PNG file')
+
+    pos = 8
+    idat = b''
+    palette = []
+    transparency = b''
+    while pos < len(data):
+        length, chunk_type = struct.unpack('>I4s', data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if chunk_type == b'IHDR':
+            width, height, depth, color_type, _, _, interlace = struct.unpack('>IIBBBBB', chunk)
+        elif chunk_type == b'PLTE':
+            palette = [tuple(chunk[i:i + 3]) for i in range(0, len(chunk), 3)]
+        elif chunk_type == b'tRNS':
+            transparency = chunk
+        elif chunk_type == b'IDAT':
+            idat += chunk
+        elif chunk_type == b'IEND':
+            break
+
+    if interlace != 0:
+        raise ValueError('interlaced images are not supported')
+    if color_type not in CHANNELS:
+        raise ValueError('unsupported color type %d' % color_type)
+    if depth != 8 and not (color_type in (0, 3) and depth in (1, 2, 4)):
+        raise ValueError('unsupported bit depth %d' % depth)
+
+    channels = CHANNELS[color_type]
+    stride = (width * channels * depth + 7) // 8
+    rows = unfilter(zlib.decompress(idat), width, height, max(1, channels * depth // 8), stride)
+
+    # returns a function telling if the pixel at x/y is set
+    def sample(row, x):
+        if depth < 8:
+            shift = 8 - depth - (x * depth) % 8
+            return (row[x * depth // 8] >> shift) & ((1 << depth) - 1)
+        return row[x * channels:(x + 1) * channels]
+
+    def is_set(x, y):
+        value = sample(rows[y], x)
+        if color_type == 0:
+            if depth < 8:
+                value = value * 255 // ((1 << depth) - 1)
+            else:
+                value = value[0]
+            return value >= 128
+        if color_type == 3:
+            index = value if depth < 8 else value[0]
+            if index < len(transparency):
+                return transparency[index] >= 128
+            r, g, b = palette[index]
+            return (r * 299 + g * 587 + b * 114) // 1000 >= 128
+        if color_type == 2:
+            r, g, b = value
+            return (r * 299 + g * 587 + b * 114) // 1000 >= 128
+        # gray + alpha / rgba
+        return value[-1] >= 128
+
+    return width, height, is_set
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert a PNG into a constexpr BitmapOverlay header')
+    parser.add_argument('input', help='input PNG')
+    parser.add_argument('output', help='output header')
+    parser.add_argument('--palette-index', type=int, required=True, help='palette index set pixels are blended with')
+    parser.add_argument('--name', help='symbol name, defaults to <input name>_overlay')
+    args = parser.parse_args()
+
+    if not 0 <= args.palette_index <= 255:
+        parser.error('palette index must be in range 0-255')
+
+    name = args.name or os.path.splitext(os.path.basename(args.input))[0].replace('-', '_').replace('.', '_') + '_overlay'
+    width, height, is_set = read_png(args.input)
+    if width > 0xffff or height > 0xffff:
+        parser.error('image too large')
+
+    # Pack bits LSB first and collect horizontal runs of set pixels
+    row_bytes = (width + 7) // 8
+    bits = bytearray(row_bytes * height)
+    runs = []
+    for y in range(height):
+        run_start = None
+        for x in range(width + 1):
+            value = x < width and is_set(x, y)
+            if value:
+                bits[y * row_bytes + x // 8] |= 1 << (x % 8)
+                if run_start is None:
+                    run_start = x
+            elif run_start is not None:
+                runs.append((run_start, y, x - run_start))
+                run_start = None
+
+    # An overlay without set pixels would need zero sized arrays, which aren't valid C++
+    if not runs:
+        raise ValueError('no set pixels, the overlay would be empty')
+
+    lines = [
+        '// Generated by png2overlay.py from %s, do not edit' % os.path.basename(args.input),
+        '#pragma once',
+        '#include "Firmware.hpp"',
+        '',
+        'inline constexpr std::uint8_t %s_bits[] = {' % name,
+    ]
+    for i in range(0, len(bits), 16):
+        lines.append(''.join('0x%02x,' % b for b in bits[i:i + 16]))
+    lines.append('};')
+    lines.append('')
+    lines.append('inline constexpr BitmapOverlay::Run %s_runs[] = {' % name)
+    for x, y, length in runs:
+        lines.append('    { %d, %d, %d },' % (x, y, length))
+    lines.append('};')
+    lines.append('')
+    lines.append('inline constexpr BitmapOverlay %s = { %d, %d, %d, %s_bits, %s_runs };' % (name, width, height, args.palette_index, name, name))
+
+    with open(args.output, 'w') as f:
+        f.write('\n'.join(lines) + '\n')
+
+if __name__ == '__main__':
+    try:
+        main()
+    except (OSError, ValueError) as e:
+        print('png2overlay: %s: %s' % (sys.argv[1] if len(sys.argv) > 1 else '', e), file=sys.stderr)
+        sys.exit(1)